@@ -9,3 +9,10 @@ no-qml {
     declarative.depends = src
     SUBDIRS += declarative
 }
+
+no-tests {
+    message(Building without tests.)
+} else {
+    tests.depends = src qtdbusextended
+    SUBDIRS += tests
+}
@@ -21,6 +21,7 @@
 
 
 #include <DBusExtendedAbstractInterface>
+#include "dbusextendedpropertiesdispatcher.h"
 
 #include <QtDBus/QDBusMetaType>
 #include <QtDBus/QDBusMessage>
@@ -29,6 +30,11 @@
 #include <QtDBus/QDBusPendingReply>
 #include <QtDBus/QDBusVariant>
 
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #define metaPropertyType(metaProperty) metaProperty.metaType()
 #else
@@ -42,6 +48,77 @@ Q_GLOBAL_STATIC_WITH_ARGS(QByteArray, dBusPropertiesChangedSignal, ("PropertiesC
 Q_GLOBAL_STATIC_WITH_ARGS(QByteArray, propertyChangedSignature, ("propertyChanged(QString,QVariant)"))
 Q_GLOBAL_STATIC_WITH_ARGS(QByteArray, propertyInvalidatedSignature, ("propertyInvalidated(QString)"))
 
+namespace Amber {
+namespace Private {
+struct DBusExtendedPropertyDescriptor
+{
+    int propertyIndex;
+    QMetaProperty metaProperty;
+    // Empty for types not registered with Qt D-Bus
+    QByteArray signature;
+};
+
+// Built once per interface class, replaces the indexOfProperty() lookups
+// and the signature computations on the property dispatch paths.
+class DBusExtendedPropertyTable
+{
+public:
+    explicit DBusExtendedPropertyTable(const QMetaObject *metaObject);
+
+    const DBusExtendedPropertyDescriptor *find(const QString &name) const;
+    const DBusExtendedPropertyDescriptor *find(const char *name) const;
+
+private:
+    QVector<DBusExtendedPropertyDescriptor> m_descriptors;
+    QHash<QString, int> m_byName;
+    QHash<QByteArray, int> m_byLatin1Name;
+};
+}
+}
+
+namespace {
+struct PropertyTableCache
+{
+    ~PropertyTableCache() { qDeleteAll(tables); }
+
+    QMutex mutex;
+    QHash<const QMetaObject *, DBusExtendedPropertyTable *> tables;
+};
+}
+
+Q_GLOBAL_STATIC(PropertyTableCache, propertyTableCache)
+
+DBusExtendedPropertyTable::DBusExtendedPropertyTable(const QMetaObject *metaObject)
+{
+    // Only the properties declared by the interface classes map to D-Bus
+    const int offset = DBusExtendedAbstractInterface::staticMetaObject.propertyCount();
+
+    m_descriptors.reserve(metaObject->propertyCount() - offset);
+    for (int i = offset; i < metaObject->propertyCount(); ++i) {
+        DBusExtendedPropertyDescriptor descriptor;
+        descriptor.propertyIndex = i;
+        descriptor.metaProperty = metaObject->property(i);
+        descriptor.signature = QDBusMetaType::typeToSignature(metaPropertyType(descriptor.metaProperty));
+
+        const QByteArray name(descriptor.metaProperty.name());
+        m_byName.insert(QString::fromLatin1(name), m_descriptors.size());
+        m_byLatin1Name.insert(name, m_descriptors.size());
+        m_descriptors.append(descriptor);
+    }
+}
+
+const DBusExtendedPropertyDescriptor *DBusExtendedPropertyTable::find(const QString &name) const
+{
+    const int index = m_byName.value(name, -1);
+    return index == -1 ? nullptr : &m_descriptors.at(index);
+}
+
+const DBusExtendedPropertyDescriptor *DBusExtendedPropertyTable::find(const char *name) const
+{
+    const int index = m_byLatin1Name.value(QByteArray::fromRawData(name, qstrlen(name)), -1);
+    return index == -1 ? nullptr : &m_descriptors.at(index);
+}
+
 
 DBusExtendedAbstractInterface::DBusExtendedAbstractInterface(const QString &service, const QString &path, const char *interface, const QDBusConnection &connection, QObject *parent)
     : QDBusAbstractInterface(service, path, interface, connection, parent)
@@ -49,11 +126,115 @@ DBusExtendedAbstractInterface::DBusExtendedAbstractInterface(const QString &serv
     , m_useCache(false)
     , m_getAllPendingCallWatcher(0)
     , m_propertiesChangedConnected(false)
+    , m_sharedPropertiesChanged(false)
+    , m_propertiesDispatcher(nullptr)
+    , m_propertyTable(nullptr)
+    , m_flushScheduled(false)
+    , m_getAllThreshold(4)
+    , m_requestStatistics()
+    , m_watchAllProperties(true)
 {
 }
 
 DBusExtendedAbstractInterface::~DBusExtendedAbstractInterface()
 {
+    if (m_propertiesDispatcher) {
+        m_propertiesDispatcher->removeInterface(this);
+        m_propertiesDispatcher->release();
+    }
+}
+
+void DBusExtendedAbstractInterface::setSharedPropertiesChanged(bool shared)
+{
+    if (m_sharedPropertiesChanged == shared) {
+        return;
+    }
+
+    if (m_propertiesChangedConnected) {
+        unsubscribePropertiesChanged();
+        m_sharedPropertiesChanged = shared;
+        subscribePropertiesChanged();
+    } else {
+        m_sharedPropertiesChanged = shared;
+    }
+}
+
+void DBusExtendedAbstractInterface::subscribePropertiesChanged()
+{
+    if (m_sharedPropertiesChanged) {
+        m_propertiesDispatcher = DBusExtendedPropertiesDispatcher::acquire(connection(), path());
+        m_propertiesDispatcher->addInterface(this);
+        return;
+    }
+
+    QStringList argumentMatch;
+    argumentMatch << interface();
+    connection().connect(service(), path(), *dBusPropertiesInterface(), *dBusPropertiesChangedSignal(),
+                         argumentMatch, QString(),
+                         this, SLOT(onPropertiesChanged(QString, QVariantMap, QStringList)));
+}
+
+void DBusExtendedAbstractInterface::unsubscribePropertiesChanged()
+{
+    if (m_propertiesDispatcher) {
+        m_propertiesDispatcher->removeInterface(this);
+        m_propertiesDispatcher->release();
+        m_propertiesDispatcher = nullptr;
+        return;
+    }
+
+    QStringList argumentMatch;
+    argumentMatch << interface();
+    connection().disconnect(service(), path(), *dBusPropertiesInterface(), *dBusPropertiesChangedSignal(),
+                            argumentMatch, QString(),
+                            this, SLOT(onPropertiesChanged(QString, QVariantMap, QStringList)));
+}
+
+const DBusExtendedPropertyTable *DBusExtendedAbstractInterface::propertyTable() const
+{
+    // Resolved lazily, metaObject() is not the final one during construction
+    if (!m_propertyTable) {
+        PropertyTableCache *cache = propertyTableCache();
+        QMutexLocker locker(&cache->mutex);
+
+        DBusExtendedPropertyTable *&table = cache->tables[metaObject()];
+        if (!table) {
+            table = new DBusExtendedPropertyTable(metaObject());
+        }
+        m_propertyTable = table;
+    }
+
+    return m_propertyTable;
+}
+
+const DBusExtendedPropertyDescriptor *DBusExtendedAbstractInterface::readablePropertyDescriptor(const char *propname)
+{
+    if (!isValid()) {
+        QString errorMessage = QStringLiteral("This Extended DBus interface is not valid yet.");
+        m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
+        qDebug() << Q_FUNC_INFO << errorMessage;
+        return nullptr;
+    }
+
+    const DBusExtendedPropertyDescriptor *descriptor = propertyTable()->find(propname);
+
+    if (!descriptor) {
+        QString errorMessage = QStringLiteral("Got unknown property \"%1\" to read")
+            .arg(QString::fromLatin1(propname));
+        m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
+        qWarning() << Q_FUNC_INFO << errorMessage;
+        return nullptr;
+    }
+
+    if (!descriptor->metaProperty.isReadable()) {
+        QString errorMessage = QStringLiteral("Property \"%1\" is NOT readable")
+            .arg(QString::fromLatin1(propname));
+        m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
+        qWarning() << Q_FUNC_INFO << errorMessage;
+        return nullptr;
+    }
+
+    return descriptor;
 }
 
 void DBusExtendedAbstractInterface::getAllProperties()
@@ -110,12 +291,7 @@ void DBusExtendedAbstractInterface::connectNotify(const QMetaMethod &signal)
         && (signal.methodSignature() == *propertyChangedSignature()
             || signal.methodSignature() == *propertyInvalidatedSignature())) {
         if (!m_propertiesChangedConnected) {
-            QStringList argumentMatch;
-            argumentMatch << interface();
-            connection().connect(service(), path(), *dBusPropertiesInterface(), *dBusPropertiesChangedSignal(),
-                                 argumentMatch, QString(),
-                                 this, SLOT(onPropertiesChanged(QString, QVariantMap, QStringList)));
-
+            subscribePropertiesChanged();
             m_propertiesChangedConnected = true;
             return;
         }
@@ -132,12 +308,7 @@ void DBusExtendedAbstractInterface::disconnectNotify(const QMetaMethod &signal)
         if (m_propertiesChangedConnected
             && 0 == receivers(propertyChangedSignature()->constData())
             && 0 == receivers(propertyInvalidatedSignature()->constData())) {
-            QStringList argumentMatch;
-            argumentMatch << interface();
-            connection().disconnect(service(), path(), *dBusPropertiesInterface(), *dBusPropertiesChangedSignal(),
-                                 argumentMatch, QString(),
-                                 this, SLOT(onPropertiesChanged(QString, QVariantMap, QStringList)));
-
+            unsubscribePropertiesChanged();
             m_propertiesChangedConnected = false;
             return;
         }
@@ -151,46 +322,25 @@ QVariant DBusExtendedAbstractInterface::internalPropGet(const char *propname, vo
     m_lastExtendedError = QDBusError();
 
     if (m_useCache) {
-        int propertyIndex = metaObject()->indexOfProperty(propname);
-        QMetaProperty metaProperty = metaObject()->property(propertyIndex);
-        return QVariant(metaPropertyType(metaProperty), propertyPtr);
+        const DBusExtendedPropertyDescriptor *descriptor = propertyTable()->find(propname);
+        Q_ASSERT(descriptor);
+        return QVariant(metaPropertyType(descriptor->metaProperty), propertyPtr);
     }
 
     if (m_sync) {
         return property(propname);
     } else {
-        if (!isValid()) {
-            QString errorMessage = QStringLiteral("This Extended DBus interface is not valid yet.");
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qDebug() << Q_FUNC_INFO << errorMessage;
-            return QVariant();
-        }
+        const DBusExtendedPropertyDescriptor *descriptor = readablePropertyDescriptor(propname);
 
-        int propertyIndex = metaObject()->indexOfProperty(propname);
-
-        if (-1 == propertyIndex) {
-            QString errorMessage = QStringLiteral("Got unknown property \"%1\" to read")
-                .arg(QString::fromLatin1(propname));
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qWarning() << Q_FUNC_INFO << errorMessage;
+        if (!descriptor) {
             return QVariant();
         }
 
-        QMetaProperty metaProperty = metaObject()->property(propertyIndex);
-
-        if (!metaProperty.isReadable()) {
-            QString errorMessage = QStringLiteral("Property \"%1\" is NOT readable")
-                .arg(QString::fromLatin1(propname));
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qWarning() << Q_FUNC_INFO << errorMessage;
-            return QVariant();
-        }
+        const QMetaProperty &metaProperty = descriptor->metaProperty;
 
         // is this metatype registered?
-        const char *expectedSignature = "";
         if (metaProperty.userType() != QMetaType::QVariant) {
-            expectedSignature = QDBusMetaType::typeToSignature(metaPropertyType(metaProperty));
-            if (0 == expectedSignature) {
+            if (descriptor->signature.isEmpty()) {
                 QString errorMessage =
                     QStringLiteral("Type %1 must be registered with Qt D-Bus "
                                    "before it can be used to read property "
@@ -223,9 +373,9 @@ void DBusExtendedAbstractInterface::internalPropSet(const char *propname, const
             return;
         }
 
-        int propertyIndex = metaObject()->indexOfProperty(propname);
+        const DBusExtendedPropertyDescriptor *descriptor = propertyTable()->find(propname);
 
-        if (-1 == propertyIndex) {
+        if (!descriptor) {
             QString errorMessage = QStringLiteral("Got unknown property \"%1\" to write")
                 .arg(QString::fromLatin1(propname));
             m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
@@ -233,7 +383,7 @@ void DBusExtendedAbstractInterface::internalPropSet(const char *propname, const
             return;
         }
 
-        QMetaProperty metaProperty = metaObject()->property(propertyIndex);
+        const QMetaProperty &metaProperty = descriptor->metaProperty;
 
         if (!metaProperty.isWritable()) {
             QString errorMessage = QStringLiteral("Property \"%1\" is NOT writable")
@@ -249,55 +399,210 @@ void DBusExtendedAbstractInterface::internalPropSet(const char *propname, const
     }
 }
 
+bool DBusExtendedAbstractInterface::fetchProperties(const QStringList &propertyNames)
+{
+    QDBusError error;
+
+    for (const QString &propertyName : propertyNames) {
+        m_lastExtendedError = QDBusError();
+
+        if (!readablePropertyDescriptor(propertyName.toLatin1().constData())) {
+            error = m_lastExtendedError;
+            continue;
+        }
+
+        asyncProperty(propertyName);
+    }
+
+    m_lastExtendedError = error;
+    return !error.isValid();
+}
+
 QVariant DBusExtendedAbstractInterface::asyncProperty(const QString &propertyName)
 {
-    QDBusMessage msg = QDBusMessage::createMethodCall(service(), path(), *dBusPropertiesInterface(), QStringLiteral("Get"));
-    msg << interface() << propertyName;
-    QDBusPendingReply<QVariant> async = connection().asyncCall(msg);
-    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, this);
+    ++m_requestStatistics.requested;
 
-    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, propertyName] { onAsyncPropertyFinished(watcher, propertyName); });
+    // The reply of the queued or pending call will carry the value
+    if (m_pendingProperties.contains(propertyName) || m_queuedProperties.contains(propertyName)) {
+        ++m_requestStatistics.merged;
+        return QVariant();
+    }
+
+    m_queuedProperties.append(propertyName);
+
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(this, "flushPropertyRequests", Qt::QueuedConnection);
+    }
 
     return QVariant();
 }
 
+void DBusExtendedAbstractInterface::flushPropertyRequests()
+{
+    m_flushScheduled = false;
+
+    const QStringList propertyNames = m_queuedProperties;
+    m_queuedProperties.clear();
+
+    if (propertyNames.isEmpty()) {
+        return;
+    }
+
+    for (const QString &propertyName : propertyNames) {
+        m_pendingProperties.insert(propertyName);
+    }
+
+    if (propertyNames.size() >= m_getAllThreshold) {
+        QDBusMessage msg = QDBusMessage::createMethodCall(service(), path(), *dBusPropertiesInterface(), QStringLiteral("GetAll"));
+        msg << interface();
+        QDBusPendingReply<QVariantMap> async = connection().asyncCall(msg);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, this);
+
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, propertyNames] { onAsyncPropertyBatchFinished(watcher, propertyNames); });
+
+        ++m_requestStatistics.getAlls;
+        return;
+    }
+
+    for (const QString &propertyName : propertyNames) {
+        QDBusMessage msg = QDBusMessage::createMethodCall(service(), path(), *dBusPropertiesInterface(), QStringLiteral("Get"));
+        msg << interface() << propertyName;
+        QDBusPendingReply<QVariant> async = connection().asyncCall(msg);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, this);
+
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, propertyName] { onAsyncPropertyFinished(watcher, propertyName); });
+
+        ++m_requestStatistics.gets;
+    }
+}
+
+void DBusExtendedAbstractInterface::setWatchedProperties(const QStringList &propertyNames)
+{
+    const DBusExtendedPropertyTable *table = propertyTable();
+
+    m_watchAllProperties = false;
+    m_watchedProperties.clear();
+
+    for (const QString &propertyName : propertyNames) {
+        const DBusExtendedPropertyDescriptor *descriptor = table->find(propertyName);
+
+        if (!descriptor) {
+            qWarning() << Q_FUNC_INFO << "Trying to watch unknown property" << propertyName;
+            continue;
+        }
+
+        m_watchedProperties.insert(descriptor->propertyIndex);
+    }
+}
+
+void DBusExtendedAbstractInterface::watchAllProperties()
+{
+    m_watchAllProperties = true;
+    m_watchedProperties.clear();
+}
+
+int DBusExtendedAbstractInterface::propertySetInterval(const QString &propertyName) const
+{
+    return m_propertySetIntervals.value(propertyName, 0);
+}
+
+void DBusExtendedAbstractInterface::setPropertySetInterval(const QString &propertyName, int msec)
+{
+    if (msec > 0) {
+        m_propertySetIntervals.insert(propertyName, msec);
+    } else {
+        m_propertySetIntervals.remove(propertyName);
+    }
+}
+
 void DBusExtendedAbstractInterface::asyncSetProperty(const QString &propertyName, const QVariant &value)
 {
+    PropertySet &propertySet = m_propertySets[propertyName];
+    propertySet.value = value;
+    propertySet.queued = true;
+
+    sendQueuedSet(propertyName);
+}
+
+void DBusExtendedAbstractInterface::sendQueuedSet(const QString &propertyName)
+{
+    PropertySet &propertySet = m_propertySets[propertyName];
+
+    if (!propertySet.queued || propertySet.inFlight || propertySet.timerScheduled) {
+        return;
+    }
+
+    const int interval = propertySetInterval(propertyName);
+    if (interval > 0 && propertySet.lastSent.isValid()) {
+        const qint64 remaining = interval - propertySet.lastSent.elapsed();
+        if (remaining > 0) {
+            propertySet.timerScheduled = true;
+            QTimer::singleShot(int(remaining), this, [this, propertyName] {
+                m_propertySets[propertyName].timerScheduled = false;
+                sendQueuedSet(propertyName);
+            });
+            return;
+        }
+    }
+
+    const QVariant value = propertySet.value;
+    propertySet.value = QVariant();
+    propertySet.queued = false;
+    propertySet.inFlight = true;
+    propertySet.lastSent.start();
+
     QDBusMessage msg = QDBusMessage::createMethodCall(service(), path(), *dBusPropertiesInterface(), QStringLiteral("Set"));
     msg << interface() << propertyName << QVariant::fromValue(QDBusVariant(value));
     QDBusPendingReply<QVariant> async = connection().asyncCall(msg);
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(async, this);
 
-    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, propertyName, value] { onAsyncSetPropertyFinished(watcher, propertyName, value); });
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, propertyName] { onAsyncSetPropertyFinished(watcher, propertyName); });
 }
 
 void DBusExtendedAbstractInterface::onAsyncPropertyFinished(QDBusPendingCallWatcher *watcher, const QString &propertyName)
 {
     QDBusPendingReply<QVariant> reply = *watcher;
+    m_pendingProperties.remove(propertyName);
 
     if (reply.isError()) {
         m_lastExtendedError = reply.error();
     } else {
-        int propertyIndex = metaObject()->indexOfProperty(propertyName.toLatin1().constData());
-        QVariant value = demarshall(interface(),
-                                    metaObject()->property(propertyIndex),
-                                    reply.value(),
-                                    &m_lastExtendedError);
-
-        if (m_lastExtendedError.isValid()) {
-            emit propertyInvalidated(propertyName);
-        } else {
-            emit propertyChanged(propertyName, value);
-        }
+        const DBusExtendedPropertyDescriptor *descriptor = propertyTable()->find(propertyName);
+        Q_ASSERT(descriptor);
+        dispatchProperty(*descriptor, propertyName, reply.value());
     }
 
     emit asyncPropertyFinished(propertyName);
     watcher->deleteLater();
 }
 
-void DBusExtendedAbstractInterface::onAsyncSetPropertyFinished(QDBusPendingCallWatcher *watcher, const QString &propertyName, const QVariant value)
+void DBusExtendedAbstractInterface::onAsyncPropertyBatchFinished(QDBusPendingCallWatcher *watcher, const QStringList &propertyNames)
+{
+    QDBusPendingReply<QVariantMap> reply = *watcher;
+
+    for (const QString &propertyName : propertyNames) {
+        m_pendingProperties.remove(propertyName);
+    }
+
+    if (reply.isError()) {
+        m_lastExtendedError = reply.error();
+    } else {
+        // Refreshes the properties that were not asked for as well
+        onPropertiesChanged(interface(), reply.value(), QStringList());
+    }
+
+    for (const QString &propertyName : propertyNames) {
+        emit asyncPropertyFinished(propertyName);
+    }
+
+    watcher->deleteLater();
+}
+
+void DBusExtendedAbstractInterface::onAsyncSetPropertyFinished(QDBusPendingCallWatcher *watcher, const QString &propertyName)
 {
     QDBusPendingReply<QVariant> reply = *watcher;
+    m_propertySets[propertyName].inFlight = false;
 
     if (reply.isError()) {
         m_lastExtendedError = reply.error();
@@ -308,13 +613,42 @@ void DBusExtendedAbstractInterface::onAsyncSetPropertyFinished(QDBusPendingCallW
     emit asyncSetPropertyFinished(propertyName);
 
     // Resetting the property to its previous value after sending the
-    // finished signal
-    if (reply.isError()) {
+    // finished signal, unless a newer value is about to be sent
+    if (reply.isError() && !m_propertySets.value(propertyName).queued) {
         m_lastExtendedError = QDBusError();
-        emit propertyChanged(propertyName, value);
+        restoreProperty(propertyName);
     }
 
     watcher->deleteLater();
+
+    sendQueuedSet(propertyName);
+}
+
+void DBusExtendedAbstractInterface::restoreProperty(const QString &propertyName)
+{
+    // Without a cache the value is read back from the service
+    if (!m_useCache) {
+        asyncProperty(propertyName);
+        return;
+    }
+
+    // The failed call never touched the cached value, the listeners that
+    // went ahead with the value that was set are told about it again
+    const DBusExtendedPropertyDescriptor *descriptor = propertyTable()->find(propertyName);
+    Q_ASSERT(descriptor);
+    const QMetaProperty &metaProperty = descriptor->metaProperty;
+    const QVariant value = metaProperty.read(this);
+
+    const QMetaMethod notifySignal = metaProperty.notifySignal();
+    if (notifySignal.isValid()) {
+        if (notifySignal.parameterCount() == 0) {
+            notifySignal.invoke(this, Qt::DirectConnection);
+        } else if (notifySignal.parameterCount() == 1 && notifySignal.parameterType(0) == metaProperty.userType()) {
+            notifySignal.invoke(this, Qt::DirectConnection, QGenericArgument(metaProperty.typeName(), value.constData()));
+        }
+    }
+
+    emit propertyChanged(propertyName, value);
 }
 
 void DBusExtendedAbstractInterface::onAsyncGetAllPropertiesFinished(QDBusPendingCallWatcher *watcher)
@@ -343,20 +677,16 @@ void DBusExtendedAbstractInterface::onPropertiesChanged(const QString& interface
                                                         const QStringList& invalidatedProperties)
 {
     if (interfaceName == interface()) {
+        const DBusExtendedPropertyTable *table = propertyTable();
+
         QVariantMap::const_iterator i = changedProperties.constBegin();
         while (i != changedProperties.constEnd()) {
-            int propertyIndex = metaObject()->indexOfProperty(i.key().toLatin1().constData());
+            const DBusExtendedPropertyDescriptor *descriptor = table->find(i.key());
 
-            if (-1 == propertyIndex) {
+            if (!descriptor) {
                 qDebug() << Q_FUNC_INFO << "Got unknown changed property" <<  i.key();
-            } else {
-                QVariant value = demarshall(interface(), metaObject()->property(propertyIndex), i.value(), &m_lastExtendedError);
-
-                if (m_lastExtendedError.isValid()) {
-                    emit propertyInvalidated(i.key());
-                } else {
-                    emit propertyChanged(i.key(), value);
-                }
+            } else if (m_watchAllProperties || m_watchedProperties.contains(descriptor->propertyIndex)) {
+                dispatchProperty(*descriptor, i.key(), i.value());
             }
 
             ++i;
@@ -364,9 +694,11 @@ void DBusExtendedAbstractInterface::onPropertiesChanged(const QString& interface
 
         QStringList::const_iterator j = invalidatedProperties.constBegin();
         while (j != invalidatedProperties.constEnd()) {
-            if (-1 == metaObject()->indexOfProperty(j->toLatin1().constData())) {
+            const DBusExtendedPropertyDescriptor *descriptor = table->find(*j);
+
+            if (!descriptor) {
                 qDebug() << Q_FUNC_INFO << "Got unknown invalidated property" <<  *j;
-            } else {
+            } else if (m_watchAllProperties || m_watchedProperties.contains(descriptor->propertyIndex)) {
                 m_lastExtendedError = QDBusError();
                 emit propertyInvalidated(*j);
             }
@@ -376,45 +708,63 @@ void DBusExtendedAbstractInterface::onPropertiesChanged(const QString& interface
     }
 }
 
-QVariant DBusExtendedAbstractInterface::demarshall(const QString &interface, const QMetaProperty &metaProperty, const QVariant &value, QDBusError *error)
+bool DBusExtendedAbstractInterface::updateProperty(int propertyIndex, const QVariant &value)
+{
+    Q_UNUSED(propertyIndex)
+    Q_UNUSED(value)
+
+    return false;
+}
+
+void DBusExtendedAbstractInterface::dispatchProperty(const DBusExtendedPropertyDescriptor &descriptor, const QString &propertyName, const QVariant &value)
 {
+    if (!checkValue(interface(), descriptor, value, &m_lastExtendedError)) {
+        emit propertyInvalidated(propertyName);
+        return;
+    }
+
+    static const QMetaMethod propertyChangedMethod = QMetaMethod::fromSignal(&DBusExtendedAbstractInterface::propertyChanged);
+
+    // The generic signal needs a demarshalled copy of the value, only
+    // build it when somebody is listening or there is no fast path.
+    if (!updateProperty(descriptor.propertyIndex, value) || isSignalConnected(propertyChangedMethod)) {
+        QVariant result = demarshall(interface(), descriptor, value, &m_lastExtendedError);
+
+        if (m_lastExtendedError.isValid()) {
+            emit propertyInvalidated(propertyName);
+        } else {
+            emit propertyChanged(propertyName, result);
+        }
+    }
+}
+
+bool DBusExtendedAbstractInterface::checkValue(const QString &interface, const DBusExtendedPropertyDescriptor &descriptor, const QVariant &value, QDBusError *error)
+{
+    const QMetaProperty &metaProperty = descriptor.metaProperty;
     Q_ASSERT(metaProperty.isValid());
     Q_ASSERT(error != 0);
 
     if (value.userType() == metaProperty.userType()) {
-        // No need demarshalling. Passing back straight away ...
         *error = QDBusError();
-        return value;
+        return true;
     }
 
-    QVariant result = QVariant(metaPropertyType(metaProperty), (void*)0);
     QString errorMessage;
-    const char *expectedSignature = QDBusMetaType::typeToSignature(metaPropertyType(metaProperty));
+    const char *expectedSignature = descriptor.signature.constData();
 
     if (value.userType() == qMetaTypeId<QDBusArgument>()) {
-        // demarshalling a DBus argument ...
-        QDBusArgument dbusArg = value.value<QDBusArgument>();
-
-        if (expectedSignature == dbusArg.currentSignature().toLatin1()) {
-            QDBusMetaType::demarshall(dbusArg, metaPropertyType(metaProperty), result.data());
-            if (!result.isValid()) {
-                errorMessage = QStringLiteral("Unexpected failure demarshalling "
-                                              "upon PropertiesChanged signal arrival "
-                                              "for property `%3.%4' (expected type `%5' (%6))")
-                    .arg(interface,
-                         QString::fromLatin1(metaProperty.name()),
-                         QString::fromLatin1(metaProperty.typeName()),
-                         expectedSignature);
-            }
-        } else {
-                errorMessage = QStringLiteral("Unexpected `user type' (%2) "
-                                              "upon PropertiesChanged signal arrival "
-                                              "for property `%3.%4' (expected type `%5' (%6))")
-                    .arg(dbusArg.currentSignature(),
-                         interface,
-                         QString::fromLatin1(metaProperty.name()),
-                         QString::fromLatin1(metaProperty.typeName()),
-                         QString::fromLatin1(expectedSignature));
+        const QDBusArgument dbusArg = value.value<QDBusArgument>();
+        const QString currentSignature = dbusArg.currentSignature();
+
+        if (currentSignature != QLatin1String(expectedSignature)) {
+            errorMessage = QStringLiteral("Unexpected `user type' (%2) "
+                                          "upon PropertiesChanged signal arrival "
+                                          "for property `%3.%4' (expected type `%5' (%6))")
+                .arg(currentSignature,
+                     interface,
+                     QString::fromLatin1(metaProperty.name()),
+                     QString::fromLatin1(metaProperty.typeName()),
+                     QString::fromLatin1(expectedSignature));
         }
     } else {
         const char *actualSignature = QDBusMetaType::typeToSignature(metaPropertyType(value));
@@ -432,7 +782,39 @@ QVariant DBusExtendedAbstractInterface::demarshall(const QString &interface, con
 
     if (errorMessage.isEmpty()) {
         *error = QDBusError();
-    } else {
+        return true;
+    }
+
+    *error = QDBusMessage::createError(QDBusError::InvalidSignature, errorMessage);
+    qDebug() << Q_FUNC_INFO << errorMessage;
+    return false;
+}
+
+QVariant DBusExtendedAbstractInterface::demarshall(const QString &interface, const DBusExtendedPropertyDescriptor &descriptor, const QVariant &value, QDBusError *error)
+{
+    const QMetaProperty &metaProperty = descriptor.metaProperty;
+
+    if (!checkValue(interface, descriptor, value, error)) {
+        return QVariant(metaPropertyType(metaProperty), (void*)0);
+    }
+
+    if (value.userType() == metaProperty.userType()) {
+        // No need demarshalling. Passing back straight away ...
+        return value;
+    }
+
+    // demarshalling a DBus argument ...
+    QVariant result = QVariant(metaPropertyType(metaProperty), (void*)0);
+    QDBusMetaType::demarshall(value.value<QDBusArgument>(), metaPropertyType(metaProperty), result.data());
+
+    if (!result.isValid()) {
+        QString errorMessage = QStringLiteral("Unexpected failure demarshalling "
+                                              "upon PropertiesChanged signal arrival "
+                                              "for property `%3.%4' (expected type `%5' (%6))")
+            .arg(interface,
+                 QString::fromLatin1(metaProperty.name()),
+                 QString::fromLatin1(metaProperty.typeName()),
+                 QString::fromLatin1(descriptor.signature));
         *error = QDBusMessage::createError(QDBusError::InvalidSignature, errorMessage);
         qDebug() << Q_FUNC_INFO << errorMessage;
     }
@@ -28,13 +28,20 @@
 #include <QDBusAbstractInterface>
 #include <QDBusError>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QMetaProperty>
+#include <QSet>
+#include <QStringList>
 
 class QDBusPendingCallWatcher;
 
 namespace Amber {
 namespace Private {
 class DBusExtendedPendingCallWatcher;
+class DBusExtendedPropertyTable;
+class DBusExtendedPropertiesDispatcher;
+struct DBusExtendedPropertyDescriptor;
 
 class QT_DBUS_EXTENDED_EXPORT DBusExtendedAbstractInterface: public QDBusAbstractInterface
 {
@@ -51,9 +58,50 @@ public:
     inline bool useCache() const { return m_useCache; }
     inline void setUseCache(bool useCache) { m_useCache = useCache; }
 
+    // When enabled, PropertiesChanged signals are received through a
+    // dispatcher shared by all the interfaces on the same connection and
+    // path, instead of a match rule of their own.
+    inline bool sharedPropertiesChanged() const { return m_sharedPropertiesChanged; }
+    void setSharedPropertiesChanged(bool shared);
+
     void getAllProperties();
     inline QDBusError lastExtendedError() const { return m_lastExtendedError; };
 
+    // Reads the properties from the service whether cached or not. The
+    // values are delivered like changes, each followed by
+    // asyncPropertyFinished(). Returns false if any of the properties
+    // can't be read, the others are fetched anyway.
+    bool fetchProperties(const QStringList &propertyNames);
+
+    // Restricts the properties taken from PropertiesChanged signals and
+    // GetAll replies, the others are dropped without being demarshalled.
+    // Dropped changes are lost, call getAllProperties() after going back
+    // to watching all the properties to catch up.
+    void setWatchedProperties(const QStringList &propertyNames);
+    void watchAllProperties();
+    inline bool watchesAllProperties() const { return m_watchAllProperties; }
+
+    // Property reads done while not using the cache are collected during
+    // one event loop iteration. Batches of at least this many distinct
+    // properties are fetched with a single GetAll instead of Gets.
+    inline int getAllThreshold() const { return m_getAllThreshold; }
+    inline void setGetAllThreshold(int threshold) { m_getAllThreshold = threshold; }
+
+    // Property writes keep at most one Set call in flight per property,
+    // newer values replace the queued one and the last value is always
+    // sent. A non zero interval additionally limits the rate of the Set
+    // calls for the property.
+    int propertySetInterval(const QString &propertyName) const;
+    void setPropertySetInterval(const QString &propertyName, int msec);
+
+    struct RequestStatistics {
+        quint64 requested;  // asynchronous property reads
+        quint64 merged;     // reads served by an already queued or pending call
+        quint64 gets;       // Get calls sent
+        quint64 getAlls;    // GetAll calls sent for batched reads
+    };
+    inline RequestStatistics requestStatistics() const { return m_requestStatistics; }
+
 protected:
     DBusExtendedAbstractInterface(const QString &service,
                                   const QString &path,
@@ -63,6 +111,13 @@ protected:
 
     void connectNotify(const QMetaMethod &signal);
     void disconnectNotify(const QMetaMethod &signal);
+
+    // Typed fast path for property updates. The value has already been
+    // checked against the D-Bus signature of the property, so it either
+    // holds the property type or a QDBusArgument to qdbus_cast<>() from.
+    // Return false to get propertyChanged() emitted instead.
+    virtual bool updateProperty(int propertyIndex, const QVariant &value);
+
     QVariant internalPropGet(const char *propname, void *propertyPtr);
     void internalPropSet(const char *propname, const QVariant &value);
 
@@ -84,19 +139,53 @@ private Q_SLOTS:
                              const QVariantMap& changedProperties,
                              const QStringList& invalidatedProperties);
     void onAsyncPropertyFinished(QDBusPendingCallWatcher *watcher, const QString &propertyName);
-    void onAsyncSetPropertyFinished(QDBusPendingCallWatcher *watcher, const QString &propertyName, const QVariant value);
+    void onAsyncPropertyBatchFinished(QDBusPendingCallWatcher *watcher, const QStringList &propertyNames);
+    void flushPropertyRequests();
+    void sendQueuedSet(const QString &propertyName);
+    void onAsyncSetPropertyFinished(QDBusPendingCallWatcher *watcher, const QString &propertyName);
     void onAsyncGetAllPropertiesFinished(QDBusPendingCallWatcher *watcher);
 
 private:
+    friend class DBusExtendedPropertiesDispatcher;
+
+    void subscribePropertiesChanged();
+    void unsubscribePropertiesChanged();
+    const DBusExtendedPropertyTable *propertyTable() const;
+    const DBusExtendedPropertyDescriptor *readablePropertyDescriptor(const char *propname);
+    void dispatchProperty(const DBusExtendedPropertyDescriptor &descriptor, const QString &propertyName, const QVariant &value);
     QVariant asyncProperty(const QString &propertyName);
+    void restoreProperty(const QString &propertyName);
     void asyncSetProperty(const QString &propertyName, const QVariant &value);
-    static QVariant demarshall(const QString &interface, const QMetaProperty &metaProperty, const QVariant &value, QDBusError *error);
+    static bool checkValue(const QString &interface, const DBusExtendedPropertyDescriptor &descriptor, const QVariant &value, QDBusError *error);
+    static QVariant demarshall(const QString &interface, const DBusExtendedPropertyDescriptor &descriptor, const QVariant &value, QDBusError *error);
 
     bool m_sync;
     bool m_useCache;
     QDBusPendingCallWatcher *m_getAllPendingCallWatcher;
     QDBusError m_lastExtendedError;
     bool m_propertiesChangedConnected;
+    bool m_sharedPropertiesChanged;
+    DBusExtendedPropertiesDispatcher *m_propertiesDispatcher;
+    mutable const DBusExtendedPropertyTable *m_propertyTable;
+    QStringList m_queuedProperties;
+    QSet<QString> m_pendingProperties;
+    bool m_flushScheduled;
+    int m_getAllThreshold;
+    RequestStatistics m_requestStatistics;
+    bool m_watchAllProperties;
+    QSet<int> m_watchedProperties;
+
+    struct PropertySet {
+        PropertySet() : inFlight(false), queued(false), timerScheduled(false) {}
+
+        bool inFlight;
+        bool queued;
+        bool timerScheduled;
+        QVariant value;
+        QElapsedTimer lastSent;
+    };
+    QHash<QString, PropertySet> m_propertySets;
+    QHash<QString, int> m_propertySetIntervals;
 };
 
 template<class External, class Internal>
@@ -111,30 +200,7 @@ External DBusExtendedAbstractInterface::internalPropGetExternal(const char *prop
     if (m_sync) {
         return qvariant_cast<External>(property(propname));
     } else {
-        if (!isValid()) {
-            QString errorMessage = QStringLiteral("This Extended DBus interface is not valid yet.");
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qDebug() << Q_FUNC_INFO << errorMessage;
-            return External();
-        }
-
-        int propertyIndex = metaObject()->indexOfProperty(propname);
-
-        if (-1 == propertyIndex) {
-            QString errorMessage = QStringLiteral("Got unknown property \"%1\" to read")
-                .arg(QString::fromLatin1(propname));
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qWarning() << Q_FUNC_INFO << errorMessage;
-            return External();
-        }
-
-        QMetaProperty metaProperty = metaObject()->property(propertyIndex);
-
-        if (!metaProperty.isReadable()) {
-            QString errorMessage = QStringLiteral("Property \"%1\" is NOT readable")
-                .arg(QString::fromLatin1(propname));
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qWarning() << Q_FUNC_INFO << errorMessage;
+        if (!readablePropertyDescriptor(propname)) {
             return External();
         }
 
@@ -155,30 +221,7 @@ Internal DBusExtendedAbstractInterface::internalPropGetInternal(const char *prop
     if (m_sync) {
         return convert(qvariant_cast<External>(property(propname)));
     } else {
-        if (!isValid()) {
-            QString errorMessage = QStringLiteral("This Extended DBus interface is not valid yet.");
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qDebug() << Q_FUNC_INFO << errorMessage;
-            return Internal();
-        }
-
-        int propertyIndex = metaObject()->indexOfProperty(propname);
-
-        if (-1 == propertyIndex) {
-            QString errorMessage = QStringLiteral("Got unknown property \"%1\" to read")
-                .arg(QString::fromLatin1(propname));
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qWarning() << Q_FUNC_INFO << errorMessage;
-            return Internal();
-        }
-
-        QMetaProperty metaProperty = metaObject()->property(propertyIndex);
-
-        if (!metaProperty.isReadable()) {
-            QString errorMessage = QStringLiteral("Property \"%1\" is NOT readable")
-                .arg(QString::fromLatin1(propname));
-            m_lastExtendedError = QDBusMessage::createError(QDBusError::Failed, errorMessage);
-            qWarning() << Q_FUNC_INFO << errorMessage;
+        if (!readablePropertyDescriptor(propname)) {
             return Internal();
         }
 
@@ -0,0 +1,316 @@
+// -*- c++ -*-
+
+/*!
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "dbusextendedpropertiesdispatcher.h"
+
+#include <DBusExtendedAbstractInterface>
+
+#include <QtDBus/QDBusArgument>
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusServiceWatcher>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
+
+using namespace Amber::Private;
+
+Q_GLOBAL_STATIC_WITH_ARGS(QString, dBusService, (QStringLiteral("org.freedesktop.DBus")))
+Q_GLOBAL_STATIC_WITH_ARGS(QString, dBusObjectPath, (QStringLiteral("/org/freedesktop/DBus")))
+Q_GLOBAL_STATIC_WITH_ARGS(QString, dBusPropertiesInterface, (QStringLiteral("org.freedesktop.DBus.Properties")))
+Q_GLOBAL_STATIC_WITH_ARGS(QString, dBusPropertiesChangedSignal, (QStringLiteral("PropertiesChanged")))
+
+namespace {
+    // Bounds the signals held back while unique names are being resolved
+    const int maximumQueuedMessages = 256;
+
+    QHash<QString, DBusExtendedPropertiesDispatcher *> s_dispatchers;
+    DBusExtendedPropertiesDispatcher::Statistics s_statistics = {};
+}
+
+DBusExtendedPropertiesDispatcher::DBusExtendedPropertiesDispatcher(const QDBusConnection &connection, const QString &path, const QString &key)
+    : QObject(nullptr)
+    , m_connection(connection)
+    , m_path(path)
+    , m_key(key)
+    , m_refCount(0)
+    , m_serviceWatcher(new QDBusServiceWatcher(this))
+    , m_resolving(0)
+{
+    m_serviceWatcher->setConnection(m_connection);
+    m_serviceWatcher->setWatchMode(QDBusServiceWatcher::WatchForOwnerChange);
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceOwnerChanged,
+            this, &DBusExtendedPropertiesDispatcher::onServiceOwnerChanged);
+
+    // No sender and no arg0 match, one rule covers every service and interface
+    m_connection.connect(QString(), m_path, *dBusPropertiesInterface(), *dBusPropertiesChangedSignal(),
+                         this, SLOT(onPropertiesChanged(QDBusMessage)));
+
+    ++s_statistics.dispatchers;
+}
+
+DBusExtendedPropertiesDispatcher::~DBusExtendedPropertiesDispatcher()
+{
+    m_connection.disconnect(QString(), m_path, *dBusPropertiesInterface(), *dBusPropertiesChangedSignal(),
+                            this, SLOT(onPropertiesChanged(QDBusMessage)));
+
+    --s_statistics.dispatchers;
+}
+
+DBusExtendedPropertiesDispatcher *DBusExtendedPropertiesDispatcher::acquire(const QDBusConnection &connection, const QString &path)
+{
+    const QString key = connection.name() + QLatin1Char('\n') + path;
+
+    DBusExtendedPropertiesDispatcher *&dispatcher = s_dispatchers[key];
+    if (!dispatcher) {
+        dispatcher = new DBusExtendedPropertiesDispatcher(connection, path, key);
+    }
+
+    ++dispatcher->m_refCount;
+    return dispatcher;
+}
+
+void DBusExtendedPropertiesDispatcher::release()
+{
+    Q_ASSERT(m_refCount > 0);
+
+    if (!--m_refCount) {
+        s_dispatchers.remove(m_key);
+        delete this;
+    }
+}
+
+DBusExtendedPropertiesDispatcher::Statistics DBusExtendedPropertiesDispatcher::statistics()
+{
+    return s_statistics;
+}
+
+void DBusExtendedPropertiesDispatcher::addInterface(DBusExtendedAbstractInterface *interface)
+{
+    const QString service = interface->service();
+    Service &entry = m_services[service];
+    const bool firstInterface = entry.interfaces.isEmpty();
+
+    entry.interfaces.append(interface);
+    ++s_statistics.interfaces;
+
+    if (!firstInterface) {
+        if (!entry.owner.isEmpty()) {
+            m_interfacesByOwner[entry.owner].append(interface);
+        }
+        return;
+    }
+
+    if (service.startsWith(QLatin1Char(':'))) {
+        // Already a unique name
+        setOwner(service, service);
+        return;
+    }
+
+    m_serviceWatcher->addWatchedService(service);
+    ++s_statistics.watchedServices;
+
+    entry.resolving = true;
+    ++m_resolving;
+
+    QDBusMessage message = QDBusMessage::createMethodCall(*dBusService(), *dBusObjectPath(),
+                                                          *dBusService(), QStringLiteral("GetNameOwner"));
+    message << service;
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_connection.asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, service] { onGetNameOwnerFinished(watcher, service); });
+}
+
+void DBusExtendedPropertiesDispatcher::removeInterface(DBusExtendedAbstractInterface *interface)
+{
+    const QString service = interface->service();
+    QHash<QString, Service>::iterator entry = m_services.find(service);
+
+    if (entry == m_services.end() || !entry->interfaces.removeOne(interface)) {
+        return;
+    }
+
+    --s_statistics.interfaces;
+
+    if (!entry->owner.isEmpty()) {
+        QHash<QString, QList<DBusExtendedAbstractInterface *> >::iterator owned = m_interfacesByOwner.find(entry->owner);
+        if (owned != m_interfacesByOwner.end()) {
+            owned->removeOne(interface);
+            if (owned->isEmpty()) {
+                m_interfacesByOwner.erase(owned);
+            }
+        }
+    }
+
+    if (!entry->interfaces.isEmpty()) {
+        return;
+    }
+
+    if (entry->resolving) {
+        --m_resolving;
+    }
+
+    if (!service.startsWith(QLatin1Char(':'))) {
+        m_serviceWatcher->removeWatchedService(service);
+        --s_statistics.watchedServices;
+    }
+
+    m_services.erase(entry);
+
+    if (!m_resolving) {
+        flushQueuedMessages();
+    }
+}
+
+void DBusExtendedPropertiesDispatcher::onPropertiesChanged(const QDBusMessage &message)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ++s_statistics.messages;
+
+    QHash<QString, QList<DBusExtendedAbstractInterface *> >::const_iterator owned = m_interfacesByOwner.constFind(message.service());
+
+    if (owned != m_interfacesByOwner.constEnd()) {
+        // Copied, dispatching may change the hash
+        const QList<DBusExtendedAbstractInterface *> interfaces = *owned;
+        dispatch(message, interfaces);
+    } else if (m_resolving) {
+        if (m_queuedMessages.size() >= maximumQueuedMessages) {
+            m_queuedMessages.removeFirst();
+            ++s_statistics.dropped;
+        }
+        m_queuedMessages.append(message);
+        ++s_statistics.queued;
+    } else {
+        ++s_statistics.dropped;
+    }
+
+    s_statistics.dispatchNsecs += timer.nsecsElapsed();
+}
+
+void DBusExtendedPropertiesDispatcher::onServiceOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner)
+{
+    Q_UNUSED(oldOwner)
+
+    if (m_services.contains(service)) {
+        setOwner(service, newOwner);
+    }
+}
+
+void DBusExtendedPropertiesDispatcher::onGetNameOwnerFinished(QDBusPendingCallWatcher *watcher, const QString &service)
+{
+    QDBusPendingReply<QString> reply = *watcher;
+    watcher->deleteLater();
+
+    QHash<QString, Service>::iterator entry = m_services.find(service);
+    if (entry == m_services.end() || !entry->resolving) {
+        return;
+    }
+
+    entry->resolving = false;
+    --m_resolving;
+
+    // The reply is newer than any owner change received before it
+    if (!reply.isError()) {
+        setOwner(service, reply.value());
+    }
+
+    flushQueuedMessages();
+}
+
+void DBusExtendedPropertiesDispatcher::setOwner(const QString &service, const QString &owner)
+{
+    Service &entry = m_services[service];
+
+    if (entry.owner == owner) {
+        return;
+    }
+
+    if (!entry.owner.isEmpty()) {
+        QList<DBusExtendedAbstractInterface *> &owned = m_interfacesByOwner[entry.owner];
+        for (DBusExtendedAbstractInterface *interface : qAsConst(entry.interfaces)) {
+            owned.removeOne(interface);
+        }
+        if (owned.isEmpty()) {
+            m_interfacesByOwner.remove(entry.owner);
+        }
+    }
+
+    entry.owner = owner;
+
+    if (!owner.isEmpty()) {
+        m_interfacesByOwner[owner].append(entry.interfaces);
+    }
+}
+
+void DBusExtendedPropertiesDispatcher::dispatch(const QDBusMessage &message, const QList<DBusExtendedAbstractInterface *> &interfaces)
+{
+    const QList<QVariant> arguments = message.arguments();
+
+    if (arguments.size() != 3) {
+        qWarning() << Q_FUNC_INFO << "Got malformed PropertiesChanged signal from" << message.service();
+        return;
+    }
+
+    const QString interfaceName = arguments.at(0).toString();
+
+    // Interfaces may get deleted by the receivers of their signals
+    QList<QPointer<DBusExtendedAbstractInterface> > receivers;
+    for (DBusExtendedAbstractInterface *interface : interfaces) {
+        if (interface->interface() == interfaceName) {
+            receivers.append(interface);
+        }
+    }
+
+    if (receivers.isEmpty()) {
+        return;
+    }
+
+    const QVariantMap changedProperties = qdbus_cast<QVariantMap>(arguments.at(1));
+    const QStringList invalidatedProperties = qdbus_cast<QStringList>(arguments.at(2));
+
+    for (const QPointer<DBusExtendedAbstractInterface> &interface : qAsConst(receivers)) {
+        if (interface) {
+            interface->onPropertiesChanged(interfaceName, changedProperties, invalidatedProperties);
+            ++s_statistics.dispatched;
+        }
+    }
+}
+
+void DBusExtendedPropertiesDispatcher::flushQueuedMessages()
+{
+    const QList<QDBusMessage> messages = m_queuedMessages;
+    m_queuedMessages.clear();
+
+    for (const QDBusMessage &message : messages) {
+        QHash<QString, QList<DBusExtendedAbstractInterface *> >::const_iterator owned = m_interfacesByOwner.constFind(message.service());
+
+        if (owned != m_interfacesByOwner.constEnd()) {
+            // Copied, dispatching may change the hash
+            const QList<DBusExtendedAbstractInterface *> interfaces = *owned;
+            dispatch(message, interfaces);
+        } else if (m_resolving) {
+            m_queuedMessages.append(message);
+        } else {
+            ++s_statistics.dropped;
+        }
+    }
+}
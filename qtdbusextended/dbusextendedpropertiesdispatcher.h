@@ -0,0 +1,116 @@
+// -*- c++ -*-
+
+/*!
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef DBUSEXTENDEDPROPERTIESDISPATCHER_H
+#define DBUSEXTENDEDPROPERTIESDISPATCHER_H
+
+#include <DBusExtended>
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class QDBusServiceWatcher;
+
+namespace Amber {
+namespace Private {
+class DBusExtendedAbstractInterface;
+
+/*
+ * Receives the PropertiesChanged signals of every remote object on one
+ * path of a connection through a single, sender-less match rule and
+ * routes them to the interfaces by the unique name of the sender.
+ *
+ * The unique names of the watched services are resolved asynchronously,
+ * signals from unknown senders arriving meanwhile are held back until
+ * the pending resolutions finish. Resolving takes a NameOwnerChanged
+ * rule per well-known service name.
+ *
+ * The rule has no sender, so the bus delivers the PropertiesChanged
+ * signals of every object on the path, of players nobody tracks too.
+ * Those wake the process only to be dropped, the statistics count them.
+ *
+ * Dispatchers are shared per connection and path and must only be used
+ * from a single thread.
+ */
+class QT_DBUS_EXTENDED_EXPORT DBusExtendedPropertiesDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DBusExtendedPropertiesDispatcher *acquire(const QDBusConnection &connection, const QString &path);
+    void release();
+
+    void addInterface(DBusExtendedAbstractInterface *interface);
+    void removeInterface(DBusExtendedAbstractInterface *interface);
+
+    struct Statistics {
+        int dispatchers;            // PropertiesChanged rules installed by all dispatchers
+        int watchedServices;        // NameOwnerChanged rules installed for the owner resolution
+        int interfaces;             // match rules the interfaces would install on their own
+        quint64 messages;           // PropertiesChanged signals received
+        quint64 dispatched;         // deliveries to interfaces
+        quint64 dropped;            // signals from senders nobody is interested in, extra wakeups
+        quint64 queued;             // signals held back for an owner resolution
+        qint64 dispatchNsecs;       // time spent routing and demarshalling
+    };
+    static Statistics statistics();
+
+private Q_SLOTS:
+    void onPropertiesChanged(const QDBusMessage &message);
+    void onServiceOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner);
+    void onGetNameOwnerFinished(QDBusPendingCallWatcher *watcher, const QString &service);
+
+private:
+    DBusExtendedPropertiesDispatcher(const QDBusConnection &connection, const QString &path, const QString &key);
+    ~DBusExtendedPropertiesDispatcher();
+
+    void setOwner(const QString &service, const QString &owner);
+    void dispatch(const QDBusMessage &message, const QList<DBusExtendedAbstractInterface *> &interfaces);
+    void flushQueuedMessages();
+
+    struct Service {
+        Service() : resolving(false) {}
+
+        QString owner;
+        bool resolving;
+        QList<DBusExtendedAbstractInterface *> interfaces;
+    };
+
+    QDBusConnection m_connection;
+    QString m_path;
+    QString m_key;
+    unsigned m_refCount;
+    QDBusServiceWatcher *m_serviceWatcher;
+    QHash<QString, Service> m_services;
+    QHash<QString, QList<DBusExtendedAbstractInterface *> > m_interfacesByOwner;
+    int m_resolving;
+    QList<QDBusMessage> m_queuedMessages;
+};
+}
+}
+
+#endif /* DBUSEXTENDEDPROPERTIESDISPATCHER_H */
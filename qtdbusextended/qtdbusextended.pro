@@ -9,7 +9,9 @@ DEFINES += QT_DBUS_EXTENDED_LIBRARY
 
 SOURCES += \
     dbusextendedabstractinterface.cpp \
+    dbusextendedpropertiesdispatcher.cpp \
 
 HEADERS += \
     dbusextended.h \
     dbusextendedabstractinterface.h \
+    dbusextendedpropertiesdispatcher.h \
@@ -36,7 +36,7 @@ QML plugin for %{name}.
 %build
 
 export PATH=$PATH:%{_qt6_bindir}
-%qmake_qt6 VERSION=`echo %{version} | sed 's/+.*//'`
+%qmake_qt6 VERSION=`echo %{version} | sed 's/+.*//'` CONFIG+=no-tests
 %make_build
 
 %install
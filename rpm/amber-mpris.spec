@@ -42,7 +42,7 @@ QML plugin for %{name} documentation.
 
 %build
 
-%qmake5 VERSION=`echo %{version} | sed 's/+.*//'`
+%qmake5 VERSION=`echo %{version} | sed 's/+.*//'` CONFIG+=no-tests
 
 make %{?_smp_mflags}
 
@@ -32,6 +32,16 @@
     list.
 */
 
+/*!
+    \qmlmethod void MprisClient::trackAllProperties()
+    \brief Starts reading all the properties of the player
+
+    The clients listed by MprisController only track the playback
+    status, the identity and the desktop entry, until they become the
+    current client or this is called. Call it before showing any of the
+    other properties of a listed client.
+*/
+
 /*!
     \qmlproperty bool MprisClient::canControl
     \brief Indicates whether the player can be controlled
@@ -61,14 +71,17 @@
 #include "mprisclient_p.h"
 #include "mprismetadata_p.h"
 #include "mpris_p.h"
+#include "mprispositionclock_p.h"
+#include "mprispositionestimator_p.h"
 
 #include <QDBusConnection>
 #include <QDBusPendingReply>
 #include <QDBusPendingCallWatcher>
-#include <QElapsedTimer>
 #include <QUrl>
 #include <QMetaObject>
 #include <QMetaEnum>
+#include <QTimer>
+#include <QtMath>
 
 #include <QDebug>
 #include <QLoggingCategory>
@@ -81,7 +94,7 @@ namespace {
 
 using namespace Amber;
 
-class Amber::MprisClientPrivate : public QObject {
+class Amber::MprisClientPrivate : public QObject, public MprisPositionClockClient {
     Q_OBJECT
 
 public:
@@ -93,6 +106,7 @@ public Q_SLOTS:
     void onAsyncGetAllRootPropertiesFinished();
     void onAsyncGetAllPlayerPropertiesFinished();
     void onAsyncPropertyFinished(const QString &propertyName);
+    void onAsyncRootPropertyFinished(const QString &propertyName);
     void onCanControlChanged();
     void onMetadataChanged();
     void onPositionChanged(qlonglong aPosition);
@@ -100,26 +114,38 @@ public Q_SLOTS:
     void onFinishedPendingCall(QDBusPendingCallWatcher *call);
     void onPlaybackStatusChanged();
     void onSeeked(qlonglong aPosition);
-    void onPositionTimeout();
 
 public:
+    qint64 positionTickDelay() const;
+    void positionTick();
+    void updatePositionTicking();
+    void reschedulePositionTick();
+
+    void watch();
+    void track();
+    void updateValid(bool wasValid);
+    void failInitialization(const QDBusError &error);
+    void failInitializationLater(const QDBusError &error);
+
     MprisClient *q_ptr;
     MprisRootInterface m_mprisRootInterface;
     MprisPlayerInterface m_mprisPlayerInterface;
 
     MprisMetaData m_metaData;
-    QTimer m_positionTimer;
+    int m_positionInterval;
+    bool m_positionTicking;
 
     void handleCall(const QDBusPendingReply<> &reply);
 
     mutable bool m_initedRootInterface;
     mutable bool m_initedPlayerInterface;
     mutable bool m_requestedPosition;
+    int m_pendingRootProperties;        // initial reads of a watched client
     bool m_canControlReceived;
-    int m_syncInterval;
+    bool m_initializationFailed;
+    bool m_fullTracking;
     unsigned m_positionConnected;
-    qlonglong m_lastPosition;
-    QElapsedTimer m_positionElapsed;
+    MprisPositionEstimator m_positionEstimator;
 };
 
 MprisClientPrivate::MprisClientPrivate(const QString &service, const QDBusConnection &connection, MprisClient *parent)
@@ -128,34 +154,143 @@ MprisClientPrivate::MprisClientPrivate(const QString &service, const QDBusConnec
     , m_mprisRootInterface(service, mprisObjectPath, connection, this)
     , m_mprisPlayerInterface(service, mprisObjectPath, connection, this)
     , m_metaData(this)
-    , m_positionTimer(this)
+    , m_positionInterval(1000)
+    , m_positionTicking(false)
     , m_initedRootInterface(false)
     , m_initedPlayerInterface(false)
     , m_requestedPosition(false)
+    , m_pendingRootProperties(0)
     , m_canControlReceived(false)
-    , m_syncInterval(5000)
+    , m_initializationFailed(false)
+    , m_fullTracking(false)
     , m_positionConnected(0)
-    , m_lastPosition(-1)
 {
-    m_positionTimer.setInterval(1000);
-    m_positionTimer.setSingleShot(false);
-    connect(&m_positionTimer, &QTimer::timeout, this, &MprisClientPrivate::onPositionTimeout);
     connect(&m_mprisPlayerInterface, &Private::DBusExtendedAbstractInterface::asyncPropertyFinished, this, &MprisClientPrivate::onAsyncPropertyFinished);
+    connect(&m_mprisRootInterface, &Private::DBusExtendedAbstractInterface::asyncPropertyFinished, this, &MprisClientPrivate::onAsyncRootPropertyFinished);
 }
 
 MprisClientPrivate::~MprisClientPrivate()
 {
+    if (m_positionTicking) {
+        MprisPositionClock::instance()->unsubscribe(this);
+    }
+}
+
+qint64 MprisClientPrivate::positionTickDelay() const
+{
+    // Due when the media position crosses the next interval boundary
+    const double rate = q_ptr->rate();
+    if (rate <= 0 || m_positionInterval <= 0) {
+        return qMax(m_positionInterval, 1);
+    }
+
+    const qint64 interval = qint64(m_positionInterval) * 1000;
+    const qint64 position = qMax<qint64>(m_positionEstimator.position(), 0);
+    const qint64 next = (position / interval + 1) * interval;
+
+    return qMax<qint64>(qCeil((next - position) / (rate * 1000)), 1);
+}
+
+void MprisClientPrivate::updatePositionTicking()
+{
+    const bool ticking = m_positionConnected && q_ptr->playbackStatus() == Mpris::Playing;
+
+    if (ticking == m_positionTicking) {
+        return;
+    }
+
+    m_positionTicking = ticking;
+    if (ticking) {
+        MprisPositionClock::instance()->subscribe(this);
+    } else {
+        MprisPositionClock::instance()->unsubscribe(this);
+    }
+}
+
+void MprisClientPrivate::reschedulePositionTick()
+{
+    if (m_positionTicking) {
+        MprisPositionClock::instance()->reschedule(this);
+    }
 }
 
-void MprisClientPrivate::onPositionTimeout()
+void MprisClientPrivate::positionTick()
 {
-    if (q_ptr->playbackStatus() == Mpris::Playing && m_positionElapsed.elapsed() > m_syncInterval) {
+    if (m_positionEstimator.resyncNeeded()) {
         q_ptr->requestPosition();
     } else {
         Q_EMIT q_ptr->positionChanged(q_ptr->position());
     }
 }
 
+void MprisClientPrivate::watch()
+{
+    // Only the playback status is needed for picking the current client,
+    // and the names for listing it. The rest of the root interface and
+    // the metadata are not materialized.
+    m_mprisRootInterface.setWatchedProperties(QStringList() << QStringLiteral("Identity")
+                                                            << QStringLiteral("DesktopEntry"));
+    m_mprisPlayerInterface.setWatchedProperties(QStringList() << QStringLiteral("PlaybackStatus"));
+
+    m_pendingRootProperties = 2;
+    if (!m_mprisRootInterface.fetchProperties(QStringList() << QStringLiteral("Identity")
+                                                            << QStringLiteral("DesktopEntry"))) {
+        failInitializationLater(m_mprisRootInterface.lastExtendedError());
+    } else if (!m_mprisPlayerInterface.fetchProperties(QStringList() << QStringLiteral("PlaybackStatus"))) {
+        failInitializationLater(m_mprisPlayerInterface.lastExtendedError());
+    }
+}
+
+void MprisClientPrivate::track()
+{
+    if (m_fullTracking) {
+        return;
+    }
+
+    m_fullTracking = true;
+    m_mprisRootInterface.watchAllProperties();
+    m_mprisPlayerInterface.watchAllProperties();
+
+    m_mprisRootInterface.getAllProperties();
+    if (m_mprisRootInterface.lastExtendedError().isValid()) {
+        failInitializationLater(m_mprisRootInterface.lastExtendedError());
+        return;
+    }
+
+    m_mprisPlayerInterface.getAllProperties();
+    if (m_mprisPlayerInterface.lastExtendedError().isValid()) {
+        failInitializationLater(m_mprisPlayerInterface.lastExtendedError());
+    }
+}
+
+void MprisClientPrivate::updateValid(bool wasValid)
+{
+    if (!wasValid && q_ptr->isValid()) {
+        Q_EMIT q_ptr->isValidChanged();
+    }
+}
+
+void MprisClientPrivate::failInitialization(const QDBusError &error)
+{
+    qCWarning(lcClient) << Q_FUNC_INFO
+                        << "Error" << error.name()
+                        << "happened:" << error.message();
+
+    // Reads failing after the client became valid only leave stale values
+    if (q_ptr->isValid() || m_initializationFailed) {
+        return;
+    }
+
+    m_initializationFailed = true;
+    Q_EMIT q_ptr->initializationFailed();
+}
+
+void MprisClientPrivate::failInitializationLater(const QDBusError &error)
+{
+    // Also called while constructing, reported once connections are made
+    QTimer::singleShot(0, this, [this, error] { failInitialization(error); });
+}
+
 void MprisClientPrivate::handleCall(const QDBusPendingReply<> &reply)
 {
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
@@ -164,6 +299,11 @@ void MprisClientPrivate::handleCall(const QDBusPendingReply<> &reply)
 }
 
 MprisClient::MprisClient(const QString &service, const QDBusConnection &connection, QObject *parent)
+    : MprisClient(service, connection, TrackAllProperties, parent)
+{
+}
+
+MprisClient::MprisClient(const QString &service, const QDBusConnection &connection, Tracking tracking, QObject *parent)
     : QObject(parent)
     , priv(new MprisClientPrivate(service, connection, this))
 {
@@ -202,8 +342,11 @@ MprisClient::MprisClient(const QString &service, const QDBusConnection &connecti
     connect(&priv->m_mprisPlayerInterface, &MprisPlayerInterface::Seeked, priv, &MprisClientPrivate::onSeeked);
     priv->m_mprisPlayerInterface.setUseCache(true);
 
-    priv->m_mprisRootInterface.getAllProperties();
-    priv->m_mprisPlayerInterface.getAllProperties();
+    if (tracking == TrackAllProperties) {
+        priv->track();
+    } else {
+        priv->watch();
+    }
 }
 
 MprisClient::~MprisClient()
@@ -215,14 +358,25 @@ bool MprisClient::isValid() const
     return priv->m_initedRootInterface && priv->m_initedPlayerInterface;
 }
 
+MprisClient::Tracking MprisClient::tracking() const
+{
+    return priv->m_fullTracking ? TrackAllProperties : TrackPlaybackStatus;
+}
+
+void MprisClient::trackAllProperties()
+{
+    priv->track();
+}
+
 int MprisClient::positionInterval() const
 {
-    return priv->m_positionTimer.interval();
+    return priv->m_positionInterval;
 }
 
 void MprisClient::setPositionInterval(int interval)
 {
-    priv->m_positionTimer.setInterval(interval);
+    priv->m_positionInterval = interval;
+    priv->reschedulePositionTick();
 }
 
 // Mpris2 Root Interface
@@ -556,10 +710,22 @@ Mpris::PlaybackStatus MprisClient::playbackStatus() const
 
 qlonglong MprisClient::position() const
 {
-    if (playbackStatus() == Mpris::Playing) {
-        return priv->m_lastPosition + priv->m_positionElapsed.elapsed() * priv->m_mprisPlayerInterface.rate();
-    }
-    return priv->m_lastPosition;
+    return priv->m_positionEstimator.position() / 1000;
+}
+
+MprisClient::PositionStatistics MprisClient::positionStatistics() const
+{
+    const MprisPositionEstimator::Statistics statistics = priv->m_positionEstimator.statistics();
+
+    PositionStatistics result;
+    result.samples = statistics.samples;
+    result.resyncs = statistics.resyncs;
+    result.lastError = statistics.lastError;
+    result.maximumError = statistics.maximumError;
+    result.averageError = statistics.averageError;
+    result.skew = statistics.skew;
+    result.resyncInterval = statistics.resyncInterval;
+    return result;
 }
 
 void MprisClient::requestPosition() const
@@ -568,10 +734,7 @@ void MprisClient::requestPosition() const
         return;
     }
 
-    priv->m_mprisPlayerInterface.setUseCache(false);
-    priv->m_mprisPlayerInterface.position();
-    priv->m_mprisPlayerInterface.setUseCache(true);
-    if (priv->m_mprisPlayerInterface.lastExtendedError().isValid()) {
+    if (!priv->m_mprisPlayerInterface.fetchProperties(QStringList() << QStringLiteral("Position"))) {
         qCWarning(lcClient) << Q_FUNC_INFO
                             << "Failed requesting the current position in the MPRIS2 Player Interface!!!";
         return;
@@ -612,9 +775,8 @@ void MprisClient::setVolume(double volume)
 void MprisClient::connectNotify(const QMetaMethod &method)
 {
     if (method == QMetaMethod::fromSignal(&MprisClient::positionChanged)) {
-        if (!priv->m_positionConnected++ && playbackStatus() == Mpris::Playing) {
-            priv->m_positionTimer.start();
-        }
+        ++priv->m_positionConnected;
+        priv->updatePositionTicking();
     }
 
     QObject::connectNotify(method);
@@ -623,9 +785,8 @@ void MprisClient::connectNotify(const QMetaMethod &method)
 void MprisClient::disconnectNotify(const QMetaMethod &method)
 {
     if (method == QMetaMethod::fromSignal(&MprisClient::positionChanged)) {
-        if (!--priv->m_positionConnected) {
-            priv->m_positionTimer.stop();
-        }
+        --priv->m_positionConnected;
+        priv->updatePositionTicking();
     }
 
     QObject::disconnectNotify(method);
@@ -636,39 +797,61 @@ void MprisClient::disconnectNotify(const QMetaMethod &method)
 void MprisClientPrivate::onAsyncGetAllRootPropertiesFinished()
 {
     if (m_mprisRootInterface.lastExtendedError().isValid()) {
-        qCWarning(lcClient) << Q_FUNC_INFO
-                            << "Error" << m_mprisRootInterface.lastExtendedError().name()
-                            << "happened:" << m_mprisRootInterface.lastExtendedError().message();
+        failInitialization(m_mprisRootInterface.lastExtendedError());
         return;
     }
 
+    const bool wasValid = q_ptr->isValid();
     m_initedRootInterface = true;
-
-    if (q_ptr->isValid()) {
-        Q_EMIT q_ptr->isValidChanged();
-    }
+    updateValid(wasValid);
 }
 
 void MprisClientPrivate::onAsyncGetAllPlayerPropertiesFinished()
 {
     if (m_mprisPlayerInterface.lastExtendedError().isValid()) {
-        qCWarning(lcClient) << Q_FUNC_INFO
-                            << "Error" << m_mprisPlayerInterface.lastExtendedError().name()
-                            << "happened:" << m_mprisPlayerInterface.lastExtendedError().message();
+        failInitialization(m_mprisPlayerInterface.lastExtendedError());
         return;
     }
 
+    const bool wasValid = q_ptr->isValid();
     m_initedPlayerInterface = true;
-
-    if (q_ptr->isValid()) {
-        Q_EMIT q_ptr->isValidChanged();
-    }
+    updateValid(wasValid);
 }
 
 void MprisClientPrivate::onAsyncPropertyFinished(const QString &propertyName)
 {
     if (propertyName == QLatin1String("Position")) {
         m_requestedPosition = false;
+    } else if (propertyName == QLatin1String("PlaybackStatus") && !m_initedPlayerInterface) {
+        // The initial read of a watched client
+        if (m_mprisPlayerInterface.lastExtendedError().isValid()) {
+            failInitialization(m_mprisPlayerInterface.lastExtendedError());
+            return;
+        }
+
+        const bool wasValid = q_ptr->isValid();
+        m_initedPlayerInterface = true;
+        updateValid(wasValid);
+    }
+}
+
+void MprisClientPrivate::onAsyncRootPropertyFinished(const QString &propertyName)
+{
+    if (m_initedRootInterface || m_pendingRootProperties <= 0
+            || (propertyName != QLatin1String("Identity") && propertyName != QLatin1String("DesktopEntry"))) {
+        return;
+    }
+
+    // DesktopEntry is optional, a failed read doesn't keep the client invalid
+    if (m_mprisRootInterface.lastExtendedError().isValid()) {
+        qCDebug(lcClient) << Q_FUNC_INFO << "Could not read" << propertyName << ":"
+                          << m_mprisRootInterface.lastExtendedError().message();
+    }
+
+    if (!--m_pendingRootProperties) {
+        const bool wasValid = q_ptr->isValid();
+        m_initedRootInterface = true;
+        updateValid(wasValid);
     }
 }
 
@@ -711,21 +894,34 @@ void MprisClientPrivate::onMetadataChanged()
     m_metaData.priv->setMetaData(m_mprisPlayerInterface.metadata());
 
     if (oldTrackId != m_metaData.trackId()) {
-        m_lastPosition = 0;
-        m_positionElapsed.start();
+        m_positionEstimator.reset(0);
+        reschedulePositionTick();
         Q_EMIT q_ptr->positionChanged(q_ptr->position());
     }
 }
 
 void MprisClientPrivate::onPositionChanged(qlonglong aPosition)
 {
-    m_positionElapsed.start();
-    m_lastPosition = aPosition / 1000;
+    m_positionEstimator.sample(aPosition);
+    reschedulePositionTick();
+
+    if (lcClient().isDebugEnabled()) {
+        const MprisPositionEstimator::Statistics statistics = m_positionEstimator.statistics();
+        qCDebug(lcClient) << q_ptr->service() << "position error" << statistics.lastError
+                          << "us, average" << qint64(statistics.averageError)
+                          << "us, maximum" << statistics.maximumError
+                          << "us, skew" << statistics.skew
+                          << "resync interval" << statistics.resyncInterval << "ms";
+    }
+
     Q_EMIT q_ptr->positionChanged(aPosition / 1000);
 }
 
 void MprisClientPrivate::onRateChanged()
 {
+    m_positionEstimator.setRate(q_ptr->rate());
+    reschedulePositionTick();
+
     if (q_ptr->playbackStatus() == Mpris::Playing) {
         q_ptr->requestPosition();
     }
@@ -738,31 +934,30 @@ void MprisClientPrivate::onPlaybackStatusChanged()
 {
     switch (q_ptr->playbackStatus()) {
     case Mpris::Paused:
-        m_lastPosition += m_positionElapsed.elapsed();
-        m_positionTimer.stop();
+        m_positionEstimator.setPlaying(false);
         break;
 
     case Mpris::Stopped:
-        m_lastPosition = 0;
-        m_positionTimer.stop();
+        m_positionEstimator.setPlaying(false);
+        m_positionEstimator.reset(0);
         Q_EMIT q_ptr->positionChanged(0);
         break;
 
     case Mpris::Playing:
-        m_positionElapsed.start();
-        if (m_positionConnected) {
-            m_positionTimer.start();
-        }
+        m_positionEstimator.setPlaying(true);
         break;
     }
 
+    updatePositionTicking();
+    reschedulePositionTick();
+
     Q_EMIT q_ptr->playbackStatusChanged();
 }
 
 void MprisClientPrivate::onSeeked(qlonglong aPosition)
 {
-    m_lastPosition = aPosition / 1000;
-    m_positionElapsed.start();
+    m_positionEstimator.reset(aPosition);
+    reschedulePositionTick();
     Q_EMIT q_ptr->positionChanged(aPosition / 1000);
     Q_EMIT q_ptr->seeked(aPosition);
 }
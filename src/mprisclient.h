@@ -75,11 +75,20 @@ class AMBER_MPRIS_EXPORT MprisClient : public QObject
     Q_PROPERTY(double volume READ volume WRITE setVolume NOTIFY volumeChanged)
 
 public:
+    enum Tracking {
+        TrackAllProperties,
+        TrackPlaybackStatus     // and the player names, until trackAllProperties()
+    };
+
     MprisClient(const QString &service, const QDBusConnection &connection, QObject *parent = 0);
+    MprisClient(const QString &service, const QDBusConnection &connection, Tracking tracking, QObject *parent = 0);
     ~MprisClient();
 
     bool isValid() const;
 
+    Tracking tracking() const;
+    Q_INVOKABLE void trackAllProperties();
+
     int positionInterval() const;
     void setPositionInterval(int interval);
 
@@ -144,9 +153,24 @@ public:
     double volume() const;
     void setVolume(double volume);
 
+    // How well the position extrapolated between the samples read from
+    // the player matched the next sample
+    struct PositionStatistics {
+        quint64 samples;        // Position samples taken
+        quint64 resyncs;        // samples compared against a prediction
+        qint64 lastError;       // prediction error of the last sample, in us
+        qint64 maximumError;    // largest absolute prediction error, in us
+        double averageError;    // moving average of the absolute error, in us
+        double skew;            // estimated player clock rate versus local
+        int resyncInterval;     // current resynchronization interval, in ms
+    };
+    PositionStatistics positionStatistics() const;
+
 Q_SIGNALS:
     void positionIntervalChanged();
     void isValidChanged();
+    // The initial properties could not be read, the client won't become valid
+    void initializationFailed();
 
     // Mpris2 Root Interface
     void canQuitChanged();
@@ -124,10 +124,26 @@ Q_SIGNALS: // SIGNALS
     void supportedMimeTypesChanged(const QStringList &supportedMimeTypes);
     void supportedUriSchemesChanged(const QStringList &supportedUriSchemes);
 
+protected:
+    bool updateProperty(int propertyIndex, const QVariant &value);
+
 private Q_SLOTS:
-    void onPropertyChanged(const QString &propertyName, const QVariant &value);
+    void onPropertyInvalidated(const QString &propertyName);
 
 private:
+    // In Q_PROPERTY declaration order
+    enum Property {
+        CanQuitProperty,
+        CanRaiseProperty,
+        CanSetFullscreenProperty,
+        DesktopEntryProperty,
+        FullscreenProperty,
+        HasTrackListProperty,
+        IdentityProperty,
+        SupportedMimeTypesProperty,
+        SupportedUriSchemesProperty
+    };
+
     bool m_canQuit;
     bool m_canRaise;
     bool m_canSetFullscreen;
@@ -312,10 +328,34 @@ Q_SIGNALS: // SIGNALS
     void volumeChanged(double volume);
     void Seeked(qlonglong Position);
 
+protected:
+    bool updateProperty(int propertyIndex, const QVariant &value);
+
 private Q_SLOTS:
-    void onPropertyChanged(const QString &propertyName, const QVariant &value);
+    void onPropertyInvalidated(const QString &propertyName);
 
 private:
+    // In Q_PROPERTY declaration order
+    enum Property {
+        CanControlProperty,
+        CanGoNextProperty,
+        CanGoPreviousProperty,
+        CanPauseProperty,
+        CanPlayProperty,
+        CanSeekProperty,
+        HasShuffleProperty,
+        HasLoopStatusProperty,
+        LoopStatusProperty,
+        MaximumRateProperty,
+        MetadataProperty,
+        MinimumRateProperty,
+        PlaybackStatusProperty,
+        PositionProperty,
+        RateProperty,
+        ShuffleProperty,
+        VolumeProperty
+    };
+
     bool m_canControl;
     bool m_canGoNext;
     bool m_canGoPrevious;
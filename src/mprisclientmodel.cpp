@@ -0,0 +1,125 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "mprisclientmodel_p.h"
+
+#include "mprisclient.h"
+
+#include <QSet>
+
+using namespace Amber;
+
+MprisClientModel::MprisClientModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+MprisClientModel::~MprisClientModel()
+{
+}
+
+int MprisClientModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant MprisClientModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+
+    const Row &row = m_rows.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case ServiceRole:
+        return row.service;
+    case ClientRole:
+        return QVariant::fromValue<QObject *>(row.client.data());
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> MprisClientModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles.insert(ServiceRole, "service");
+    roles.insert(ClientRole, "client");
+    return roles;
+}
+
+bool MprisClientModel::setClients(const QList<MprisClient *> &clients)
+{
+    QSet<MprisClient *> wanted;
+    wanted.reserve(clients.size());
+    for (MprisClient *client : clients) {
+        wanted.insert(client);
+    }
+    bool changed = false;
+
+    // Removals first, deleted clients are gone from the wanted set too
+    for (int i = m_rows.size() - 1; i >= 0; --i) {
+        MprisClient *client = m_rows.at(i).client.data();
+        if (!client || !wanted.contains(client)) {
+            beginRemoveRows(QModelIndex(), i, i);
+            m_rows.removeAt(i);
+            endRemoveRows();
+            changed = true;
+        }
+    }
+
+    for (int i = 0; i < clients.size(); ++i) {
+        MprisClient *client = clients.at(i);
+
+        if (i < m_rows.size() && m_rows.at(i).client == client) {
+            continue;
+        }
+
+        const int from = indexOf(client, i + 1);
+        if (from >= 0) {
+            beginMoveRows(QModelIndex(), from, from, QModelIndex(), i);
+            m_rows.move(from, i);
+            endMoveRows();
+        } else {
+            Row row;
+            row.service = client->service();
+            row.client = client;
+            beginInsertRows(QModelIndex(), i, i);
+            m_rows.insert(i, row);
+            endInsertRows();
+        }
+        changed = true;
+    }
+
+    return changed;
+}
+
+int MprisClientModel::indexOf(MprisClient *client, int from) const
+{
+    for (int i = from; i < m_rows.size(); ++i) {
+        if (m_rows.at(i).client == client) {
+            return i;
+        }
+    }
+
+    return -1;
+}
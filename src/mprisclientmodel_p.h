@@ -0,0 +1,89 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the public API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+//
+
+
+#ifndef MPRISCLIENTMODEL_P_H
+#define MPRISCLIENTMODEL_P_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QString>
+
+namespace Amber {
+
+class MprisClient;
+
+/*
+ * List model of the clients available to a controller, in the same
+ * order as MprisController::availableClients.
+ *
+ * The model is synchronized with setClients(), which reports only the
+ * rows actually inserted, moved or removed, so the delegates of the
+ * unchanged rows are kept.
+ */
+class MprisClientModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        ServiceRole = Qt::UserRole,
+        ClientRole
+    };
+
+    MprisClientModel(QObject *parent = nullptr);
+    ~MprisClientModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QHash<int, QByteArray> roleNames() const;
+
+    bool setClients(const QList<MprisClient *> &clients);
+
+private:
+    struct Row {
+        QString service;
+        QPointer<MprisClient> client;
+    };
+
+    int indexOf(MprisClient *client, int from) const;
+
+    // The clients can be deleted before the next synchronization,
+    // the rows keep the service name and a guarded pointer.
+    QList<Row> m_rows;
+};
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "mprisclientregistry_p.h"
+
+#include "mprisclient.h"
+#include "ambermpris_p.h"
+#include "mprisservicediscovery_p.h"
+
+#include <QSharedPointer>
+
+using namespace Amber;
+
+namespace {
+    MprisClientRegistry *s_instance = nullptr;
+}
+
+MprisClientRegistry::MprisClientRegistry()
+    : QObject(nullptr)
+    , m_refCount(0)
+    , m_discovery(MprisServiceDiscovery::acquire())
+    , m_ready(false)
+{
+    connect(m_discovery, &MprisServiceDiscovery::serviceAppeared, this, &MprisClientRegistry::onServiceAppeared);
+    connect(m_discovery, &MprisServiceDiscovery::serviceVanished, this, &MprisClientRegistry::onServiceVanished);
+    connect(m_discovery, &MprisServiceDiscovery::ready, this, &MprisClientRegistry::onDiscoveryReady);
+
+    // Services enumerated before, for an earlier registry
+    const QStringList services = m_discovery->services();
+    for (const QString &service : services) {
+        onServiceAppeared(service);
+    }
+
+    if (m_discovery->isReady()) {
+        onDiscoveryReady();
+    }
+}
+
+MprisClientRegistry::~MprisClientRegistry()
+{
+    qDeleteAll(m_pendingClients);
+    qDeleteAll(m_clients);
+
+    m_discovery->release();
+}
+
+MprisClientRegistry *MprisClientRegistry::acquire()
+{
+    if (!s_instance) {
+        s_instance = new MprisClientRegistry;
+    }
+
+    ++s_instance->m_refCount;
+    return s_instance;
+}
+
+void MprisClientRegistry::release()
+{
+    Q_ASSERT(this == s_instance && m_refCount > 0);
+
+    if (!--m_refCount) {
+        s_instance = nullptr;
+        delete this;
+    }
+}
+
+bool MprisClientRegistry::isReady() const
+{
+    return m_ready;
+}
+
+QList<MprisClient *> MprisClientRegistry::clients() const
+{
+    return m_clients.values();
+}
+
+MprisClient *MprisClientRegistry::client(const QString &service) const
+{
+    return m_clients.value(service);
+}
+
+void MprisClientRegistry::onServiceAppeared(const QString &service)
+{
+    // Registered again, the old client is of no use anymore
+    onServiceVanished(service);
+
+    MprisClient *client = new MprisClient(service, getDBusConnection(), MprisClient::TrackPlaybackStatus, this);
+
+    if (client->isValid()) {
+        onClientValid(client);
+        return;
+    }
+
+    m_pendingClients.insert(service, client);
+
+    connect(client, &MprisClient::initializationFailed, this, [this, client] {
+        if (m_pendingClients.value(client->service()) != client) {
+            return;
+        }
+
+        // Not listed, but the enumeration is done with it
+        m_pendingClients.remove(client->service());
+        disconnect(client, nullptr, this, nullptr);
+        client->deleteLater();
+        resolveInitialService(client->service());
+    });
+
+    QSharedPointer<QMetaObject::Connection> connection(new QMetaObject::Connection);
+    *connection = connect(client, &MprisClient::isValidChanged, this, [this, client, connection] {
+        if (client->isValid()) {
+            QObject::disconnect(*connection);
+
+            // Replaced by a client of a newer registration meanwhile
+            if (m_pendingClients.value(client->service()) != client) {
+                return;
+            }
+
+            m_pendingClients.remove(client->service());
+            onClientValid(client);
+        }
+    });
+}
+
+void MprisClientRegistry::onServiceVanished(const QString &service)
+{
+    MprisClient *client = m_pendingClients.take(service);
+
+    if (client) {
+        // Its pending reply must not make it valid before it's gone
+        disconnect(client, nullptr, this, nullptr);
+        client->deleteLater();
+        resolveInitialService(service);
+        return;
+    }
+
+    client = m_clients.take(service);
+
+    if (client) {
+        Q_EMIT clientRemoved(client);
+        client->deleteLater();
+    }
+}
+
+void MprisClientRegistry::onDiscoveryReady()
+{
+    // Ready once the clients of the enumerated services settled
+    for (auto it = m_pendingClients.constBegin(); it != m_pendingClients.constEnd(); ++it) {
+        m_initialServices.insert(it.key());
+    }
+
+    updateReady();
+}
+
+void MprisClientRegistry::onClientValid(MprisClient *client)
+{
+    m_clients.insert(client->service(), client);
+    Q_EMIT clientAdded(client);
+
+    resolveInitialService(client->service());
+}
+
+void MprisClientRegistry::resolveInitialService(const QString &service)
+{
+    if (m_initialServices.remove(service)) {
+        updateReady();
+    }
+}
+
+void MprisClientRegistry::updateReady()
+{
+    if (m_ready || !m_discovery->isReady() || !m_initialServices.isEmpty()) {
+        return;
+    }
+
+    m_ready = true;
+    Q_EMIT ready();
+}
@@ -0,0 +1,109 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the public API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+//
+
+
+#ifndef MPRISCLIENTREGISTRY_P_H
+#define MPRISCLIENTREGISTRY_P_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+namespace Amber {
+
+class MprisClient;
+class MprisServiceDiscovery;
+
+/*
+ * Owns one MprisClient per Mpris2 service on the bus.
+ *
+ * Every controller in the process shares the clients, and with them
+ * their property caches and bus subscriptions. The controllers only
+ * apply their own selection policy on top.
+ *
+ * New clients only track the playback status and the player names.
+ * That's all the selection policies and the lists need, the rest is
+ * fetched once MprisClient::trackAllProperties() is called.
+ *
+ * clientAdded() is emitted once a client got its initial properties,
+ * clientRemoved() when its service vanished or got registered again.
+ * Removed clients are deleted on the next event loop iteration. Clients
+ * failing to read their initial properties are dropped unlisted.
+ *
+ * ready() is emitted once the services on the bus are enumerated and
+ * each of their clients either turned valid or failed.
+ *
+ * The instance must only be used from a single thread.
+ */
+class MprisClientRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MprisClientRegistry *acquire();
+    void release();
+
+    bool isReady() const;
+    QList<MprisClient *> clients() const;
+    MprisClient *client(const QString &service) const;
+
+Q_SIGNALS:
+    void ready();
+    void clientAdded(MprisClient *client);
+    void clientRemoved(MprisClient *client);
+
+private Q_SLOTS:
+    void onServiceAppeared(const QString &service);
+    void onServiceVanished(const QString &service);
+    void onDiscoveryReady();
+
+private:
+    MprisClientRegistry();
+    ~MprisClientRegistry();
+
+    void onClientValid(MprisClient *client);
+    void resolveInitialService(const QString &service);
+    void updateReady();
+
+    unsigned m_refCount;
+    MprisServiceDiscovery *m_discovery;
+    bool m_ready;
+    QSet<QString> m_initialServices;    // enumerated, client not settled yet
+    QHash<QString, MprisClient *> m_pendingClients;
+    QHash<QString, MprisClient *> m_clients;
+};
+
+}
+
+#endif
@@ -88,6 +88,36 @@
     Note, the life time of the returned objects is only as long as they are
     advertised by the manager, using them after the property has changed
     will cause a crash.
+
+    The clients only track their playback status, identity and desktop
+    entry until MprisClient::trackAllProperties() is called on them.
+*/
+
+/*!
+    \qmlproperty QAbstractItemModel MprisController::clientModel
+    \brief Model of the current players
+
+    The model has the same contents and order as availableServices and
+    provides the \c service and \c client roles. Unlike the list
+    properties it reports the individual rows inserted, moved and
+    removed, so delegates of unaffected players are kept.
+
+    Changes to the list are reported at most once per event loop
+    iteration, after the outcome of the triggering event is known.
+
+    As with availableClients, call MprisClient::trackAllProperties()
+    before showing more than the playback status and the player names.
+*/
+
+/*!
+    \qmlproperty bool MprisController::ready
+    \brief Indicates whether the initial player enumeration has finished
+
+    The players already registered on the bus are enumerated
+    asynchronously after the controller is created. Until this property
+    becomes true the availableServices list may be incomplete. It turns
+    true once each of the enumerated players got its initial properties
+    read, or failed to.
 */
 
 /*!
@@ -476,15 +506,16 @@
 #include "mpriscontroller.h"
 
 #include "mprisclient.h"
+#include "mprisclientmodel_p.h"
+#include "mprisclientregistry_p.h"
 #include "ambermpris_p.h"
 #include "mprismetadataproxy.h"
 
-#include <algorithm>
+#include <QHash>
 #include <QMetaMethod>
 #include <QTimer>
+#include <QVector>
 #include <QDBusConnection>
-#include <QDBusConnectionInterface>
-#include <QSharedPointer>
 
 #include <QDebug>
 #include <QLoggingCategory>
@@ -493,15 +524,244 @@ using namespace Amber;
 
 namespace {
     const QString mprisNameSpace = QStringLiteral("org.mpris.MediaPlayer2.");
-    const QString dBusService = QStringLiteral("org.freedesktop.DBus");
-    const QString dBusObjectPath = QStringLiteral("/org/freedesktop/DBus");
-    const QString dBusInterface = QStringLiteral("org.freedesktop.DBus");
-    const QString dBusNameOwnerChangedSignal = QStringLiteral("NameOwnerChanged");
 
     Q_LOGGING_CATEGORY(lcController, "org.amber.mpris.controller", QtWarningMsg)
+
+    typedef void (MprisClient::*ClientSignal)();
+    typedef void (MprisController::*ControllerSignal)();
+
+    struct ForwardedSignal {
+        ClientSignal clientSignal;
+        ControllerSignal controllerSignal;
+    };
+
+    // In the order of MprisControllerState::Field
+    const ForwardedSignal forwardedSignals[] = {
+        // Mpris Root Interface
+        { &MprisClient::canQuitChanged, &MprisController::canQuitChanged },
+        { &MprisClient::canRaiseChanged, &MprisController::canRaiseChanged },
+        { &MprisClient::canSetFullscreenChanged, &MprisController::canSetFullscreenChanged },
+        { &MprisClient::desktopEntryChanged, &MprisController::desktopEntryChanged },
+        { &MprisClient::fullscreenChanged, &MprisController::fullscreenChanged },
+        { &MprisClient::hasTrackListChanged, &MprisController::hasTrackListChanged },
+        { &MprisClient::identityChanged, &MprisController::identityChanged },
+        { &MprisClient::supportedUriSchemesChanged, &MprisController::supportedUriSchemesChanged },
+        { &MprisClient::supportedMimeTypesChanged, &MprisController::supportedMimeTypesChanged },
+
+        // Mpris Player Interface
+        { &MprisClient::canControlChanged, &MprisController::canControlChanged },
+        { &MprisClient::canGoNextChanged, &MprisController::canGoNextChanged },
+        { &MprisClient::canGoPreviousChanged, &MprisController::canGoPreviousChanged },
+        { &MprisClient::canPauseChanged, &MprisController::canPauseChanged },
+        { &MprisClient::canPlayChanged, &MprisController::canPlayChanged },
+        { &MprisClient::canSeekChanged, &MprisController::canSeekChanged },
+        { &MprisClient::hasShuffleChanged, &MprisController::hasShuffleChanged },
+        { &MprisClient::hasLoopStatusChanged, &MprisController::hasLoopStatusChanged },
+        { &MprisClient::loopStatusChanged, &MprisController::loopStatusChanged },
+        { &MprisClient::maximumRateChanged, &MprisController::maximumRateChanged },
+        { &MprisClient::minimumRateChanged, &MprisController::minimumRateChanged },
+        { &MprisClient::playbackStatusChanged, &MprisController::playbackStatusChanged },
+        { &MprisClient::rateChanged, &MprisController::rateChanged },
+        { &MprisClient::shuffleChanged, &MprisController::shuffleChanged },
+        { &MprisClient::volumeChanged, &MprisController::volumeChanged }
+    };
+    const int forwardedSignalCount = sizeof(forwardedSignals) / sizeof(forwardedSignals[0]);
+
+    // Maps the signal index of a client signal to its field
+    int forwardedSignalField(int signalIndex)
+    {
+        static const QVector<int> fields = [] {
+            QVector<int> result(MprisClient::staticMetaObject.methodCount(), -1);
+            for (int i = 0; i < forwardedSignalCount; ++i) {
+                result[QMetaMethod::fromSignal(forwardedSignals[i].clientSignal).methodIndex()] = i;
+            }
+            return result;
+        }();
+
+        return signalIndex >= 0 && signalIndex < fields.size() ? fields.at(signalIndex) : -1;
+    }
 }
 
 namespace Amber {
+// The values the controller last reported for the current client
+class MprisControllerState
+{
+public:
+    enum Field {
+        CanQuit,
+        CanRaise,
+        CanSetFullscreen,
+        DesktopEntry,
+        Fullscreen,
+        HasTrackList,
+        Identity,
+        SupportedUriSchemes,
+        SupportedMimeTypes,
+        CanControl,
+        CanGoNext,
+        CanGoPrevious,
+        CanPause,
+        CanPlay,
+        CanSeek,
+        HasShuffle,
+        HasLoopStatus,
+        LoopStatus,
+        MaximumRate,
+        MinimumRate,
+        PlaybackStatus,
+        Rate,
+        Shuffle,
+        Volume,
+        FieldCount
+    };
+
+    // Values reported without a current client
+    MprisControllerState()
+        : flags(0)
+        , loopStatus(Mpris::LoopNone)
+        , maximumRate(1)
+        , minimumRate(1)
+        , playbackStatus(Mpris::Stopped)
+        , rate(1)
+        , volume(0)
+    {
+    }
+
+    explicit MprisControllerState(const MprisClient *client)
+        : MprisControllerState()
+    {
+        for (int field = 0; field < FieldCount; ++field) {
+            update(client, field);
+        }
+    }
+
+    void update(const MprisClient *client, int field)
+    {
+        switch (field) {
+        case CanQuit: setFlag(field, client->canQuit()); break;
+        case CanRaise: setFlag(field, client->canRaise()); break;
+        case CanSetFullscreen: setFlag(field, client->canSetFullscreen()); break;
+        case DesktopEntry: desktopEntry = client->desktopEntry(); break;
+        case Fullscreen: setFlag(field, client->fullscreen()); break;
+        case HasTrackList: setFlag(field, client->hasTrackList()); break;
+        case Identity: identity = client->identity(); break;
+        case SupportedUriSchemes: supportedUriSchemes = client->supportedUriSchemes(); break;
+        case SupportedMimeTypes: supportedMimeTypes = client->supportedMimeTypes(); break;
+        case CanControl: setFlag(field, client->canControl()); break;
+        case CanGoNext: setFlag(field, client->canGoNext()); break;
+        case CanGoPrevious: setFlag(field, client->canGoPrevious()); break;
+        case CanPause: setFlag(field, client->canPause()); break;
+        case CanPlay: setFlag(field, client->canPlay()); break;
+        case CanSeek: setFlag(field, client->canSeek()); break;
+        case HasShuffle: setFlag(field, client->hasShuffle()); break;
+        case HasLoopStatus: setFlag(field, client->hasLoopStatus()); break;
+        case LoopStatus: loopStatus = client->loopStatus(); break;
+        case MaximumRate: maximumRate = client->maximumRate(); break;
+        case MinimumRate: minimumRate = client->minimumRate(); break;
+        case PlaybackStatus: playbackStatus = client->playbackStatus(); break;
+        case Rate: rate = client->rate(); break;
+        case Shuffle: setFlag(field, client->shuffle()); break;
+        case Volume: volume = client->volume(); break;
+        default: break;
+        }
+    }
+
+    // Bit per field that differs between the states
+    quint32 diff(const MprisControllerState &other) const
+    {
+        quint32 result = flags ^ other.flags;
+
+        if (desktopEntry != other.desktopEntry) result |= 1u << DesktopEntry;
+        if (identity != other.identity) result |= 1u << Identity;
+        if (supportedUriSchemes != other.supportedUriSchemes) result |= 1u << SupportedUriSchemes;
+        if (supportedMimeTypes != other.supportedMimeTypes) result |= 1u << SupportedMimeTypes;
+        if (loopStatus != other.loopStatus) result |= 1u << LoopStatus;
+        if (maximumRate != other.maximumRate) result |= 1u << MaximumRate;
+        if (minimumRate != other.minimumRate) result |= 1u << MinimumRate;
+        if (playbackStatus != other.playbackStatus) result |= 1u << PlaybackStatus;
+        if (rate != other.rate) result |= 1u << Rate;
+        if (volume != other.volume) result |= 1u << Volume;
+
+        return result;
+    }
+
+    // The boolean fields are kept as bits of the same mask
+    quint32 flags;
+    QString desktopEntry;
+    QString identity;
+    QStringList supportedUriSchemes;
+    QStringList supportedMimeTypes;
+    Mpris::LoopStatus loopStatus;
+    double maximumRate;
+    double minimumRate;
+    Mpris::PlaybackStatus playbackStatus;
+    double rate;
+    double volume;
+
+private:
+    void setFlag(int field, bool value)
+    {
+        if (value) {
+            flags |= 1u << field;
+        } else {
+            flags &= ~(1u << field);
+        }
+    }
+};
+
+Q_STATIC_ASSERT(forwardedSignalCount == MprisControllerState::FieldCount);
+
+struct MprisClientEntry
+{
+    explicit MprisClientEntry(MprisClient *c)
+        : client(c), prev(nullptr), next(nullptr), playing(false) {}
+
+    MprisClient *client;
+    MprisClientEntry *prev;
+    MprisClientEntry *next;
+    bool playing;
+};
+
+// Intrusive, most recent first list of available clients
+class MprisClientEntryList
+{
+public:
+    MprisClientEntryList() : m_first(nullptr), m_size(0) {}
+
+    MprisClientEntry *first() const { return m_first; }
+    int size() const { return m_size; }
+    bool isEmpty() const { return !m_first; }
+
+    void prepend(MprisClientEntry *entry)
+    {
+        entry->prev = nullptr;
+        entry->next = m_first;
+        if (m_first) {
+            m_first->prev = entry;
+        }
+        m_first = entry;
+        ++m_size;
+    }
+
+    void remove(MprisClientEntry *entry)
+    {
+        if (entry->prev) {
+            entry->prev->next = entry->next;
+        } else {
+            m_first = entry->next;
+        }
+        if (entry->next) {
+            entry->next->prev = entry->prev;
+        }
+        entry->prev = entry->next = nullptr;
+        --m_size;
+    }
+
+private:
+    MprisClientEntry *m_first;
+    int m_size;
+};
+
 class MprisControllerPrivate : public QObject
 {
     Q_OBJECT
@@ -511,14 +771,23 @@ public:
     ~MprisControllerPrivate();
 
 public Q_SLOTS:
-    void onNameOwnerChanged(const QString &service, const QString &oldOwner, const QString& newOwner);
-    void onServiceAppeared(const QString &service);
-    void onServiceVanished(const QString &service);
+    void onClientAdded(MprisClient *client);
+    void onClientRemoved(MprisClient *client);
     void onAvailableClientPlaybackStatusChanged(MprisClient *client);
+    void onDiscoveryReady();
+    void flushAvailableServices();
+    void onClientStateChanged();
 
 public:
     MprisClient *availableClient(const QString &service) const;
-    MprisClient *pendingClient(const QString &service) const;
+    MprisClient *firstAvailableClient() const;
+    MprisClient *firstOtherPlayingClient() const;
+    bool moveToPlaying(MprisClientEntry *entry);
+    bool moveToIdle(MprisClientEntry *entry);
+    void unlink(MprisClientEntry *entry);
+    QList<MprisClient *> orderedClients() const;
+    void scheduleAvailableServicesChanged();
+    void connectClient(MprisClient *client);
     void setCurrentClient(MprisClient *client);
     bool checkClient(const char *callerName) const;
 
@@ -526,11 +795,18 @@ public:
     bool m_singleService;
     QString m_singleServiceName;
     MprisClient *m_currentClient;
+    MprisControllerState m_state;
     QDBusConnection m_connection;
+    MprisClientRegistry *m_registry;
+    bool m_ready;
     MprisMetaDataProxy m_metaData;
-    QList<MprisClient *> m_pendingClients;
-    QList<MprisClient *> m_availableClients;
-    QList<MprisClient *> m_otherPlayingClients;
+    QHash<QString, MprisClientEntry *> m_availableClients;
+    // The available clients are the playing ones followed by the idle
+    // ones, both most recent first.
+    MprisClientEntryList m_playingClients;
+    MprisClientEntryList m_idleClients;
+    MprisClientModel *m_clientModel;
+    bool m_availableServicesScheduled;
     unsigned m_positionConnectionCount;
 };
 }
@@ -541,32 +817,49 @@ MprisControllerPrivate::MprisControllerPrivate(MprisController *parent)
     , m_singleService(false)
     , m_currentClient(nullptr)
     , m_connection(getDBusConnection())
+    , m_registry(nullptr)
+    , m_ready(false)
     , m_metaData(this)
+    , m_clientModel(new MprisClientModel(this))
+    , m_availableServicesScheduled(false)
     , m_positionConnectionCount(0)
 {
     if (!m_connection.isConnected()) {
         qCWarning(lcController) << "Mpris: Failed attempting to connect to DBus";
+        m_ready = true;
         return;
     }
 
-    m_connection.connect(dBusService, dBusObjectPath, dBusInterface, dBusNameOwnerChangedSignal,
-                         QStringList(), QString(),
-                         this, SLOT(onNameOwnerChanged(QString, QString, QString)));
-
-    QTimer::singleShot(0, [this]() {
-        QStringList serviceNames = m_connection.interface()->registeredServiceNames();
-        for (auto i = serviceNames.constBegin();
-             i != serviceNames.constEnd();
-             ++i) {
-            if (i->startsWith(mprisNameSpace)) {
-                onServiceAppeared(*i);
-            }
+    m_registry = MprisClientRegistry::acquire();
+    connect(m_registry, &MprisClientRegistry::clientAdded, this, &MprisControllerPrivate::onClientAdded);
+    connect(m_registry, &MprisClientRegistry::clientRemoved, this, &MprisControllerPrivate::onClientRemoved);
+
+    if (!m_registry->isReady()) {
+        // The initial services are delivered through clientAdded
+        // once the asynchronous enumeration finishes.
+        connect(m_registry, &MprisClientRegistry::ready, this, &MprisControllerPrivate::onDiscoveryReady);
+    }
+
+    // Clients already shared with other controllers, pick them up
+    // once the controller is fully constructed.
+    QTimer::singleShot(0, this, [this]() {
+        const QList<MprisClient *> clients = m_registry->clients();
+        for (MprisClient *client : clients) {
+            onClientAdded(client);
+        }
+        if (m_registry->isReady()) {
+            onDiscoveryReady();
         }
     });
 }
 
 MprisControllerPrivate::~MprisControllerPrivate()
 {
+    qDeleteAll(m_availableClients);
+
+    if (m_registry) {
+        m_registry->release();
+    }
 }
 
 MprisController::MprisController(QObject *parent)
@@ -660,9 +953,11 @@ void MprisController::setSingleService(bool single)
             priv->m_singleServiceName = priv->m_currentClient->service();
         }
     } else if (!priv->m_currentClient
-               || (priv->m_currentClient->playbackStatus() != Mpris::Playing
-                   && !priv->m_otherPlayingClients.isEmpty())) {
-        priv->setCurrentClient(priv->m_otherPlayingClients[0]);
+               || priv->m_currentClient->playbackStatus() != Mpris::Playing) {
+        MprisClient *playingClient = priv->firstOtherPlayingClient();
+        if (playingClient) {
+            priv->setCurrentClient(playingClient);
+        }
     }
 
     priv->m_singleService = single;
@@ -696,29 +991,43 @@ void MprisController::setCurrentService(const QString &service)
 QStringList MprisController::availableServices() const
 {
     QStringList result;
+    result.reserve(priv->m_availableClients.size());
 
-    for (auto i = priv->m_availableClients.constBegin();
-         i != priv->m_availableClients.constEnd();
-         ++i) {
-        result.append((*i)->service());
+    for (MprisClientEntry *entry = priv->m_playingClients.first(); entry; entry = entry->next) {
+        result.append(entry->client->service());
+    }
+    for (MprisClientEntry *entry = priv->m_idleClients.first(); entry; entry = entry->next) {
+        result.append(entry->client->service());
     }
 
     return result;
 }
 
+bool MprisController::isReady() const
+{
+    return priv->m_ready;
+}
+
 QList<QObject *> MprisController::availableClients() const
 {
     QList<QObject *> result;
+    result.reserve(priv->m_availableClients.size());
 
-    for (auto i = priv->m_availableClients.constBegin();
-         i != priv->m_availableClients.constEnd();
-         ++i) {
-        result << *i;
+    for (MprisClientEntry *entry = priv->m_playingClients.first(); entry; entry = entry->next) {
+        result << entry->client;
+    }
+    for (MprisClientEntry *entry = priv->m_idleClients.first(); entry; entry = entry->next) {
+        result << entry->client;
     }
 
     return result;
 }
 
+QAbstractItemModel *MprisController::clientModel() const
+{
+    return priv->m_clientModel;
+}
+
 // Mpris2 Root Interface
 bool MprisController::canQuit() const
 {
@@ -913,380 +1222,271 @@ void MprisController::disconnectNotify(const QMetaMethod &method)
 
 // Private
 
-void MprisControllerPrivate::onNameOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner)
+void MprisControllerPrivate::onClientAdded(MprisClient *client)
 {
-    // Unfortunately, QDBus doesn't allow flexible signal watchers.
-    // Would it allow them, we could pass the filter "arg0namespace='org.mpris.MediaPlayer2'"
-    // Therefore, we will receive here all the name changes in the
-    // bus, not just the ones for our name space of interest, and we
-    // will have to filter on our own :(
-
-    if (!service.startsWith(mprisNameSpace)) {
+    if (m_availableClients.contains(client->service())) {
         return;
     }
 
-    if (oldOwner.isEmpty()) {
-        onServiceAppeared(service);
-        return;
-    }
-
-    if (newOwner.isEmpty()) {
-        onServiceVanished(service);
-        return;
+    MprisClientEntry *entry = new MprisClientEntry(client);
+    m_availableClients.insert(client->service(), entry);
+    m_idleClients.prepend(entry);
+    if ((m_singleService && client->service() == m_singleServiceName)
+        || (!m_singleService && !m_currentClient)) {
+        setCurrentClient(client);
     }
-
-    // Service changed owner. Nothing to do ...
+    connectClient(client);
+    connect(client, &MprisClient::playbackStatusChanged, this, [this, client] { onAvailableClientPlaybackStatusChanged(client); });
+    onAvailableClientPlaybackStatusChanged(client);
+    scheduleAvailableServicesChanged();
 }
 
-void MprisControllerPrivate::onServiceAppeared(const QString &service)
+void MprisControllerPrivate::onClientRemoved(MprisClient *client)
 {
-    MprisClient *client = availableClient(service);
-    if (client) {
-        Q_ASSERT(m_availableClients.contains(client));
-        m_availableClients.removeOne(client);
-        m_otherPlayingClients.removeOne(client);
+    MprisClientEntry *entry = m_availableClients.value(client->service());
 
-        if (client == m_currentClient) {
-            if (m_availableClients.isEmpty()) {
-                m_currentClient = 0;
-            } else {
-                m_currentClient = m_availableClients[0];
-            }
-        }
-
-        Q_EMIT q_ptr->availableServicesChanged();
-        client->deleteLater();
-    } else {
-        client = pendingClient(service);
-
-        if (client) {
-            m_pendingClients.removeOne(client);
-            client->deleteLater();
-        }
-    }
-
-    client = new MprisClient(service, getDBusConnection(), this);
-
-    auto validHandler = [this, client] {
-        bool emitted = false;
-        QMetaObject::Connection connection = connect(q_ptr, &MprisController::availableServicesChanged, this, [&emitted] { emitted = true; }, Qt::DirectConnection);
-        m_pendingClients.removeOne(client);
-        m_availableClients.prepend(client);
-        if ((m_singleService && client->service() == m_singleServiceName)
-            || (!m_singleService && !m_currentClient)) {
-            setCurrentClient(client);
-        } else {
-            m_otherPlayingClients.prepend(client);
-        }
-        connect(client, &MprisClient::playbackStatusChanged, this, [this, client] { onAvailableClientPlaybackStatusChanged(client); });
-        onAvailableClientPlaybackStatusChanged(client);
-
-        if (!emitted) {
-            Q_EMIT q_ptr->availableServicesChanged();
-        }
-        q_ptr->disconnect(connection);
-    };
-
-    if (!client->isValid()) {
-        QSharedPointer<QMetaObject::Connection> connection(new QMetaObject::Connection);
-        *connection = connect(client, &MprisClient::isValidChanged, this, [client, connection, validHandler] {
-            if (client->isValid()) {
-                client->disconnect(*connection);
-                validHandler();
-            }
-        });
-        m_pendingClients << client;
+    if (!entry || entry->client != client) {
         return;
     }
 
-    validHandler();
-}
+    m_availableClients.remove(client->service());
+    unlink(entry);
+    delete entry;
 
-void MprisControllerPrivate::onServiceVanished(const QString &service)
-{
-    MprisClient *client = pendingClient(service);
-
-    if (client) {
-        m_pendingClients.removeOne(client);
-        client->deleteLater();
-
-        return;
-    }
-
-    client = availableClient(service);
-
-    if (!client) {
-        return;
-    }
-
-    m_availableClients.removeOne(client);
+    // The client is shared, only this controller lets go of it
+    client->disconnect(this);
 
     if (m_currentClient == client) {
+        MprisClient *playingClient = firstOtherPlayingClient();
+
         if (m_singleService || m_availableClients.isEmpty()) {
             setCurrentClient(nullptr);
-        } else if (!m_otherPlayingClients.isEmpty()) {
-            setCurrentClient(m_otherPlayingClients[0]);
+        } else if (playingClient) {
+            setCurrentClient(playingClient);
         } else {
-            setCurrentClient(m_availableClients[0]);
+            setCurrentClient(firstAvailableClient());
         }
     }
-    m_otherPlayingClients.removeOne(client);
-
-    Q_EMIT q_ptr->availableServicesChanged();
 
-    if (client) {
-        client->deleteLater();
-    }
+    scheduleAvailableServicesChanged();
 }
 
 void MprisControllerPrivate::onAvailableClientPlaybackStatusChanged(MprisClient *client)
 {
+    MprisClientEntry *entry = m_availableClients.value(client->service());
+
+    if (!entry || entry->client != client) {
+        return;
+    }
+
     if (m_currentClient == client) {
         if (m_currentClient->playbackStatus() == Mpris::Playing) {
-            if (m_availableClients[0] != m_currentClient) {
-                m_availableClients.move(m_availableClients.indexOf(m_currentClient), 0);
-                Q_EMIT q_ptr->availableServicesChanged();
+            if (moveToPlaying(entry)) {
+                scheduleAvailableServicesChanged();
             }
             return;
         }
 
-        if (!m_otherPlayingClients.isEmpty()) {
-            m_availableClients.move(m_availableClients.indexOf(m_currentClient), m_otherPlayingClients.length());
-            MprisClient *currentClient = m_otherPlayingClients.takeFirst();
-            m_availableClients.move(m_availableClients.indexOf(currentClient), 0);
-            Q_EMIT q_ptr->availableServicesChanged();
+        MprisClient *playingClient = firstOtherPlayingClient();
+        if (playingClient) {
+            moveToIdle(entry);
+            moveToPlaying(m_availableClients.value(playingClient->service()));
+            scheduleAvailableServicesChanged();
 
             if (!m_singleService) {
-                setCurrentClient(currentClient);
+                setCurrentClient(playingClient);
             }
+        } else {
+            // Nobody else playing, the client stays first in the list
+            moveToIdle(entry);
         }
     } else {
         if (client->playbackStatus() != Mpris::Playing) {
-            if (m_otherPlayingClients.removeOne(client)) {
-                m_availableClients.move(m_availableClients.indexOf(client), m_otherPlayingClients.length());
-                Q_EMIT q_ptr->availableServicesChanged();
+            if (entry->playing) {
+                moveToIdle(entry);
+                scheduleAvailableServicesChanged();
             }
             return;
         }
 
-        m_availableClients.move(m_availableClients.indexOf(client), 0);
-        Q_EMIT q_ptr->availableServicesChanged();
+        moveToPlaying(entry);
+        scheduleAvailableServicesChanged();
 
         if (!m_singleService && (!m_currentClient
             || m_currentClient->playbackStatus() != Mpris::Playing)) {
             setCurrentClient(client);
-        } else {
-            m_otherPlayingClients.removeOne(client); // Just in case, shouldn't be needed
-            m_otherPlayingClients.prepend(client);
         }
     }
 }
 
-MprisClient *MprisControllerPrivate::pendingClient(const QString &service) const
+void MprisControllerPrivate::onDiscoveryReady()
 {
-    auto result = std::find_if(m_pendingClients.cbegin(),
-                               m_pendingClients.cend(),
-                               [service](MprisClient *c) { return c->service() == service; });
+    if (m_ready) {
+        return;
+    }
 
-    if (result != m_pendingClients.cend()) {
-        return *result;
+    // The lists are complete, publish them before announcing it
+    if (m_availableServicesScheduled) {
+        flushAvailableServices();
     }
 
-    return nullptr;
+    m_ready = true;
+    Q_EMIT q_ptr->readyChanged();
 }
 
 MprisClient *MprisControllerPrivate::availableClient(const QString &service) const
 {
-    auto result = std::find_if(m_availableClients.cbegin(),
-                               m_availableClients.cend(),
-                               [service](MprisClient *c) { return c->service() == service; });
+    MprisClientEntry *entry = m_availableClients.value(service);
+    return entry ? entry->client : nullptr;
+}
 
-    if (result != m_availableClients.cend()) {
-        return *result;
+MprisClient *MprisControllerPrivate::firstAvailableClient() const
+{
+    MprisClientEntry *entry = m_playingClients.isEmpty() ? m_idleClients.first() : m_playingClients.first();
+    return entry ? entry->client : nullptr;
+}
+
+MprisClient *MprisControllerPrivate::firstOtherPlayingClient() const
+{
+    // The current client, if playing, is normally the first one
+    for (MprisClientEntry *entry = m_playingClients.first(); entry; entry = entry->next) {
+        if (entry->client != m_currentClient) {
+            return entry->client;
+        }
     }
 
     return nullptr;
 }
 
-void MprisControllerPrivate::setCurrentClient(MprisClient *client)
+bool MprisControllerPrivate::moveToPlaying(MprisClientEntry *entry)
 {
-    if (client == m_currentClient) {
-        return;
+    if (entry->playing && m_playingClients.first() == entry) {
+        return false;
     }
 
-    if (m_currentClient) {
-        // Mpris Root Interface
-        disconnect(m_currentClient, &MprisClient::canQuitChanged, q_ptr, &MprisController::canQuitChanged);
-        disconnect(m_currentClient, &MprisClient::canRaiseChanged, q_ptr, &MprisController::canRaiseChanged);
-        disconnect(m_currentClient, &MprisClient::canSetFullscreenChanged, q_ptr, &MprisController::canSetFullscreenChanged);
-        disconnect(m_currentClient, &MprisClient::desktopEntryChanged, q_ptr, &MprisController::desktopEntryChanged);
-        disconnect(m_currentClient, &MprisClient::fullscreenChanged, q_ptr, &MprisController::fullscreenChanged);
-        disconnect(m_currentClient, &MprisClient::hasTrackListChanged, q_ptr, &MprisController::hasTrackListChanged);
-        disconnect(m_currentClient, &MprisClient::identityChanged, q_ptr, &MprisController::identityChanged);
-        disconnect(m_currentClient, &MprisClient::supportedUriSchemesChanged, q_ptr, &MprisController::supportedUriSchemesChanged);
-        disconnect(m_currentClient, &MprisClient::supportedMimeTypesChanged, q_ptr, &MprisController::supportedMimeTypesChanged);
-
-        // Mpris Player Interface
-        disconnect(m_currentClient, &MprisClient::canControlChanged, q_ptr, &MprisController::canControlChanged);
-        disconnect(m_currentClient, &MprisClient::canGoNextChanged, q_ptr, &MprisController::canGoNextChanged);
-        disconnect(m_currentClient, &MprisClient::canGoPreviousChanged, q_ptr, &MprisController::canGoPreviousChanged);
-        disconnect(m_currentClient, &MprisClient::canPauseChanged, q_ptr, &MprisController::canPauseChanged);
-        disconnect(m_currentClient, &MprisClient::canPlayChanged, q_ptr, &MprisController::canPlayChanged);
-        disconnect(m_currentClient, &MprisClient::canSeekChanged, q_ptr, &MprisController::canSeekChanged);
-        disconnect(m_currentClient, &MprisClient::hasShuffleChanged, q_ptr, &MprisController::hasShuffleChanged);
-        disconnect(m_currentClient, &MprisClient::hasLoopStatusChanged, q_ptr, &MprisController::hasLoopStatusChanged);
-        disconnect(m_currentClient, &MprisClient::loopStatusChanged, q_ptr, &MprisController::loopStatusChanged);
-        disconnect(m_currentClient, &MprisClient::maximumRateChanged, q_ptr, &MprisController::maximumRateChanged);
-        disconnect(m_currentClient, &MprisClient::minimumRateChanged, q_ptr, &MprisController::minimumRateChanged);
-        disconnect(m_currentClient, &MprisClient::playbackStatusChanged, q_ptr, &MprisController::playbackStatusChanged);
-        disconnect(m_currentClient, &MprisClient::positionChanged, q_ptr, &MprisController::positionChanged);
-        disconnect(m_currentClient, &MprisClient::rateChanged, q_ptr, &MprisController::rateChanged);
-        disconnect(m_currentClient, &MprisClient::shuffleChanged, q_ptr, &MprisController::shuffleChanged);
-        disconnect(m_currentClient, &MprisClient::volumeChanged, q_ptr, &MprisController::volumeChanged);
-        disconnect(m_currentClient, &MprisClient::seeked, q_ptr, &MprisController::seeked);
+    unlink(entry);
+    entry->playing = true;
+    m_playingClients.prepend(entry);
+    return true;
+}
 
-        if (m_currentClient->playbackStatus() == Mpris::Playing) {
-            m_otherPlayingClients.prepend(m_currentClient);
-        }
+bool MprisControllerPrivate::moveToIdle(MprisClientEntry *entry)
+{
+    if (!entry->playing && m_idleClients.first() == entry) {
+        return false;
     }
 
-    bool oldCanQuit = q_ptr->canQuit();
-    bool oldCanRaise = q_ptr->canRaise();
-    bool oldCanSetFullscreen = q_ptr->canSetFullscreen();
-    QString oldDesktopEntry = q_ptr->desktopEntry();
-    bool oldFullscreen = q_ptr->fullscreen();
-    bool oldHasTrackList = q_ptr->hasTrackList();
-    QString oldIdentity = q_ptr->identity();
-    QStringList oldSupportedUriSchemes = q_ptr->supportedUriSchemes();
-    QStringList oldSupportedMimeTypes = q_ptr->supportedMimeTypes();
-    bool oldCanControl = q_ptr->canControl();
-    bool oldCanGoNext = q_ptr->canGoNext();
-    bool oldCanGoPrevious = q_ptr->canGoPrevious();
-    bool oldCanPause = q_ptr->canPause();
-    bool oldCanPlay = q_ptr->canPlay();
-    bool oldCanSeek = q_ptr->canSeek();
-    bool oldHasShuffle = q_ptr->hasShuffle();
-    bool oldHasLoopStatus = q_ptr->hasLoopStatus();
-    Mpris::LoopStatus oldLoopStatus = q_ptr->loopStatus();
-    double oldMaximumRate = q_ptr->maximumRate();
-    double oldMinimumRate = q_ptr->minimumRate();
-    Mpris::PlaybackStatus oldPlaybackStatus = q_ptr->playbackStatus();
-    double oldRate = q_ptr->rate();
-    bool oldShuffle = q_ptr->shuffle();
-    double oldVolume = q_ptr->volume();
-
-    m_currentClient = client;
-    m_metaData.setTarget(m_currentClient ? m_currentClient->metaData() : nullptr);
+    unlink(entry);
+    entry->playing = false;
+    m_idleClients.prepend(entry);
+    return true;
+}
 
-    if (oldCanQuit != q_ptr->canQuit()) {
-        Q_EMIT q_ptr->canQuitChanged();
-    }
-    if (oldCanRaise != q_ptr->canRaise()) {
-        Q_EMIT q_ptr->canRaiseChanged();
-    }
-    if (oldCanSetFullscreen != q_ptr->canSetFullscreen()) {
-        Q_EMIT q_ptr->canSetFullscreenChanged();
-    }
-    if (oldDesktopEntry != q_ptr->desktopEntry()) {
-        Q_EMIT q_ptr->desktopEntryChanged();
-    }
-    if (oldFullscreen != q_ptr->fullscreen()) {
-        Q_EMIT q_ptr->fullscreenChanged();
-    }
-    if (oldHasTrackList != q_ptr->hasTrackList()) {
-        Q_EMIT q_ptr->hasTrackListChanged();
-    }
-    if (oldIdentity != q_ptr->identity()) {
-        Q_EMIT q_ptr->identityChanged();
-    }
-    if (oldSupportedUriSchemes != q_ptr->supportedUriSchemes()) {
-        Q_EMIT q_ptr->supportedUriSchemesChanged();
-    }
-    if (oldSupportedMimeTypes != q_ptr->supportedMimeTypes()) {
-        Q_EMIT q_ptr->supportedMimeTypesChanged();
+void MprisControllerPrivate::unlink(MprisClientEntry *entry)
+{
+    if (entry->playing) {
+        m_playingClients.remove(entry);
+    } else {
+        m_idleClients.remove(entry);
     }
+}
 
-    if (oldCanControl != q_ptr->canControl()) {
-        Q_EMIT q_ptr->canControlChanged();
-    }
-    if (oldCanGoNext != q_ptr->canGoNext()) {
-        Q_EMIT q_ptr->canGoNextChanged();
-    }
-    if (oldCanGoPrevious != q_ptr->canGoPrevious()) {
-        Q_EMIT q_ptr->canGoPreviousChanged();
-    }
-    if (oldCanPause != q_ptr->canPause()) {
-        Q_EMIT q_ptr->canPauseChanged();
-    }
-    if (oldCanPlay != q_ptr->canPlay()) {
-        Q_EMIT q_ptr->canPlayChanged();
-    }
-    if (oldCanSeek != q_ptr->canSeek()) {
-        Q_EMIT q_ptr->canSeekChanged();
+QList<MprisClient *> MprisControllerPrivate::orderedClients() const
+{
+    QList<MprisClient *> result;
+    result.reserve(m_availableClients.size());
+
+    for (MprisClientEntry *entry = m_playingClients.first(); entry; entry = entry->next) {
+        result << entry->client;
     }
-    if (oldHasShuffle != q_ptr->hasShuffle()) {
-        Q_EMIT q_ptr->hasShuffleChanged();
+    for (MprisClientEntry *entry = m_idleClients.first(); entry; entry = entry->next) {
+        result << entry->client;
     }
-    if (oldHasLoopStatus != q_ptr->hasLoopStatus()) {
-        Q_EMIT q_ptr->hasLoopStatusChanged();
+
+    return result;
+}
+
+void MprisControllerPrivate::scheduleAvailableServicesChanged()
+{
+    // A single event may reorder the list several times, notify only
+    // about the outcome once control returns to the event loop.
+    if (m_availableServicesScheduled) {
+        return;
     }
-    if (oldLoopStatus != q_ptr->loopStatus()) {
-        Q_EMIT q_ptr->loopStatusChanged();
+
+    m_availableServicesScheduled = true;
+    QMetaObject::invokeMethod(this, "flushAvailableServices", Qt::QueuedConnection);
+}
+
+void MprisControllerPrivate::flushAvailableServices()
+{
+    m_availableServicesScheduled = false;
+
+    if (m_clientModel->setClients(orderedClients())) {
+        Q_EMIT q_ptr->availableServicesChanged();
     }
-    if (oldMaximumRate != q_ptr->maximumRate()) {
-        Q_EMIT q_ptr->maximumRateChanged();
+}
+
+void MprisControllerPrivate::onClientStateChanged()
+{
+    // Every available client is connected, only the current one counts
+    MprisClient *client = static_cast<MprisClient *>(sender());
+    if (client != m_currentClient) {
+        return;
     }
-    if (oldMinimumRate != q_ptr->minimumRate()) {
-        Q_EMIT q_ptr->minimumRateChanged();
+
+    const int field = forwardedSignalField(senderSignalIndex());
+    if (field < 0) {
+        return;
     }
-    if (oldPlaybackStatus != q_ptr->playbackStatus()) {
-        Q_EMIT q_ptr->playbackStatusChanged();
+
+    m_state.update(client, field);
+    (q_ptr->*forwardedSignals[field].controllerSignal)();
+}
+
+void MprisControllerPrivate::connectClient(MprisClient *client)
+{
+    for (int i = 0; i < forwardedSignalCount; ++i) {
+        connect(client, forwardedSignals[i].clientSignal, this, &MprisControllerPrivate::onClientStateChanged);
     }
-    if (oldRate != q_ptr->rate()) {
-        Q_EMIT q_ptr->rateChanged();
+
+    connect(client, &MprisClient::seeked, this, [this, client](qlonglong position) {
+        if (client == m_currentClient) {
+            Q_EMIT q_ptr->seeked(position);
+        }
+    });
+}
+
+void MprisControllerPrivate::setCurrentClient(MprisClient *client)
+{
+    if (client == m_currentClient) {
+        return;
     }
-    if (oldShuffle != q_ptr->shuffle()) {
-        Q_EMIT q_ptr->shuffleChanged();
+
+    if (client) {
+        // The rest of the state follows through the forwarded signals
+        client->trackAllProperties();
     }
-    if (oldVolume != q_ptr->volume()) {
-        Q_EMIT q_ptr->volumeChanged();
+
+    const MprisControllerState state = client ? MprisControllerState(client) : MprisControllerState();
+    const quint32 changed = m_state.diff(state);
+
+    // Position updates are timer driven, they are connected on demand only
+    if (m_currentClient && m_positionConnectionCount) {
+        disconnect(m_currentClient, &MprisClient::positionChanged, q_ptr, &MprisController::positionChanged);
     }
 
-    if (m_currentClient) {
-        // Mpris Root Interface
-        connect(m_currentClient, &MprisClient::canQuitChanged, q_ptr, &MprisController::canQuitChanged);
-        connect(m_currentClient, &MprisClient::canRaiseChanged, q_ptr, &MprisController::canRaiseChanged);
-        connect(m_currentClient, &MprisClient::canSetFullscreenChanged, q_ptr, &MprisController::canSetFullscreenChanged);
-        connect(m_currentClient, &MprisClient::desktopEntryChanged, q_ptr, &MprisController::desktopEntryChanged);
-        connect(m_currentClient, &MprisClient::fullscreenChanged, q_ptr, &MprisController::fullscreenChanged);
-        connect(m_currentClient, &MprisClient::hasTrackListChanged, q_ptr, &MprisController::hasTrackListChanged);
-        connect(m_currentClient, &MprisClient::identityChanged, q_ptr, &MprisController::identityChanged);
-        connect(m_currentClient, &MprisClient::supportedUriSchemesChanged, q_ptr, &MprisController::supportedUriSchemesChanged);
-        connect(m_currentClient, &MprisClient::supportedMimeTypesChanged, q_ptr, &MprisController::supportedMimeTypesChanged);
-        connect(m_currentClient, &MprisClient::canControlChanged, q_ptr, &MprisController::canControlChanged);
+    m_currentClient = client;
+    m_state = state;
+    m_metaData.setTarget(m_currentClient ? m_currentClient->metaData() : nullptr);
 
-        // Mpris Player Interface
-        connect(m_currentClient, &MprisClient::canGoNextChanged, q_ptr, &MprisController::canGoNextChanged);
-        connect(m_currentClient, &MprisClient::canGoPreviousChanged, q_ptr, &MprisController::canGoPreviousChanged);
-        connect(m_currentClient, &MprisClient::canPauseChanged, q_ptr, &MprisController::canPauseChanged);
-        connect(m_currentClient, &MprisClient::canPlayChanged, q_ptr, &MprisController::canPlayChanged);
-        connect(m_currentClient, &MprisClient::canSeekChanged, q_ptr, &MprisController::canSeekChanged);
-        connect(m_currentClient, &MprisClient::hasShuffleChanged, q_ptr, &MprisController::hasShuffleChanged);
-        connect(m_currentClient, &MprisClient::hasLoopStatusChanged, q_ptr, &MprisController::hasLoopStatusChanged);
-        connect(m_currentClient, &MprisClient::loopStatusChanged, q_ptr, &MprisController::loopStatusChanged);
-        connect(m_currentClient, &MprisClient::maximumRateChanged, q_ptr, &MprisController::maximumRateChanged);
-        connect(m_currentClient, &MprisClient::minimumRateChanged, q_ptr, &MprisController::minimumRateChanged);
-        connect(m_currentClient, &MprisClient::playbackStatusChanged, q_ptr, &MprisController::playbackStatusChanged);
-        if (m_positionConnectionCount) {
-            connect(m_currentClient, &MprisClient::positionChanged, q_ptr, &MprisController::positionChanged);
-        }
-        connect(m_currentClient, &MprisClient::rateChanged, q_ptr, &MprisController::rateChanged);
-        connect(m_currentClient, &MprisClient::shuffleChanged, q_ptr, &MprisController::shuffleChanged);
-        connect(m_currentClient, &MprisClient::volumeChanged, q_ptr, &MprisController::volumeChanged);
-        connect(m_currentClient, &MprisClient::seeked, q_ptr, &MprisController::seeked);
+    if (m_currentClient && m_positionConnectionCount) {
+        connect(m_currentClient, &MprisClient::positionChanged, q_ptr, &MprisController::positionChanged);
+    }
 
-        if (m_currentClient->playbackStatus() == Mpris::Playing) {
-            m_otherPlayingClients.removeOne(m_currentClient);
+    for (int field = 0; field < MprisControllerState::FieldCount; ++field) {
+        if (changed & (1u << field)) {
+            (q_ptr->*forwardedSignals[field].controllerSignal)();
         }
     }
 
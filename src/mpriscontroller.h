@@ -35,6 +35,8 @@
 #include <QString>
 #include <QStringList>
 
+class QAbstractItemModel;
+
 namespace Amber {
 
 class MprisControllerPrivate;
@@ -47,6 +49,8 @@ class AMBER_MPRIS_EXPORT MprisController : public QObject
     Q_PROPERTY(QString currentService READ currentService WRITE setCurrentService NOTIFY currentServiceChanged)
     Q_PROPERTY(QStringList availableServices READ availableServices NOTIFY availableServicesChanged)
     Q_PROPERTY(QList<QObject *> availableClients READ availableClients NOTIFY availableServicesChanged)
+    Q_PROPERTY(QAbstractItemModel *clientModel READ clientModel CONSTANT)
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged)
 
     // Mpris2 Root Interface
     Q_PROPERTY(bool canQuit READ canQuit NOTIFY canQuitChanged)
@@ -106,6 +110,9 @@ public:
 
     QStringList availableServices() const;
     QList<QObject *> availableClients() const;
+    QAbstractItemModel *clientModel() const;
+
+    bool isReady() const;
 
     // Mpris2 Root Interface
     bool canQuit() const;
@@ -156,6 +163,7 @@ Q_SIGNALS:
     void singleServiceChanged();
     void currentServiceChanged();
     void availableServicesChanged();
+    void readyChanged();
 
     // Mpris2 Root Interface
     void canQuitChanged();
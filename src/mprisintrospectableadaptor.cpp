@@ -47,6 +47,7 @@ namespace {
 MprisIntrospectableAdaptor::MprisIntrospectableAdaptor(MprisPropertiesAdaptor *propertiesAdaptor, MprisPlayerPrivate *parent)
     : QDBusAbstractAdaptor(parent)
     , m_propertiesAdaptor(propertiesAdaptor)
+    , m_xmlMaskGeneration(0)
 {
 }
 
@@ -56,14 +57,31 @@ MprisIntrospectableAdaptor::~MprisIntrospectableAdaptor()
 
 QString MprisIntrospectableAdaptor::Introspect()
 {
+    m_propertiesAdaptor->lockProperties();
+
+    generate();
+    return m_xml;
+}
+
+QString MprisIntrospectableAdaptor::interfaceXml()
+{
+    generate();
+    return m_interfaceXml;
+}
+
+void MprisIntrospectableAdaptor::generate()
+{
+    // The adaptors are fixed, only the masked properties alter the output
+    if (!m_xml.isNull() && m_xmlMaskGeneration == m_propertiesAdaptor->maskGeneration()) {
+        return;
+    }
+
+    QBuffer standard;
     QBuffer xml;
-    if (!xml.open(QIODevice::WriteOnly)) {
+    if (!standard.open(QIODevice::WriteOnly) || !xml.open(QIODevice::WriteOnly)) {
         qCCritical(lcIntrospectable) << "Could not open buffer to write";
-        return QString();
+        return;
     }
-    xml.write(IntrospectPreface);
-
-    m_propertiesAdaptor->lockProperties();
 
     for (const QObject *child : parent()->children()) {
         const QDBusAbstractAdaptor *adaptor = qobject_cast<const QDBusAbstractAdaptor *>(child);
@@ -76,8 +94,9 @@ QString MprisIntrospectableAdaptor::Introspect()
             if (!content || !content[0])
                 continue;
 
-            if (!m_propertiesAdaptor->hasMaskedProperties()
-                    || adaptor == this || adaptor == m_propertiesAdaptor) {
+            if (adaptor == this || adaptor == m_propertiesAdaptor) {
+                standard.write(content);
+            } else if (!m_propertiesAdaptor->hasMaskedProperties()) {
                 xml.write(content);
             } else {
                 QXmlStreamReader reader(content);
@@ -113,7 +132,13 @@ QString MprisIntrospectableAdaptor::Introspect()
         }
     }
 
-    xml.write(IntrospectPostface);
+    standard.close();
     xml.close();
-    return QString::fromUtf8(xml.data());
+
+    m_interfaceXml = QString::fromUtf8(xml.data());
+    m_xml = QString::fromLatin1(IntrospectPreface)
+            + QString::fromUtf8(standard.data())
+            + m_interfaceXml
+            + QString::fromLatin1(IntrospectPostface);
+    m_xmlMaskGeneration = m_propertiesAdaptor->maskGeneration();
 }
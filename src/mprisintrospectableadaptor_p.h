@@ -53,11 +53,19 @@ public:
     MprisIntrospectableAdaptor(MprisPropertiesAdaptor *propertiesAdaptor, MprisPlayerPrivate *parent);
     virtual ~MprisIntrospectableAdaptor();
 
+    // The player interfaces only, without the standard D-Bus ones
+    QString interfaceXml();
+
 public Q_SLOTS: // METHODS
     QString Introspect();
 
 private:
+    void generate();
+
     MprisPropertiesAdaptor *m_propertiesAdaptor;
+    QString m_xml;                  // null until generated
+    QString m_interfaceXml;
+    quint64 m_xmlMaskGeneration;
 };
 
 } // namespace Amber
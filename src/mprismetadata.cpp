@@ -27,6 +27,10 @@
     All properties may be undefined if not applicable or known.
     A default trackId of \c{/org/mpris/MediaPlayer2/TrackList/NoTrack}
     will be returned if one is not defined.
+
+    Every property has a change signal of its own, which is emitted only
+    when the value of that property actually changed. metaDataChanged()
+    is emitted once for any change.
 */
 
 /*!
@@ -214,6 +218,8 @@
 
 #include <QVariant>
 #include <QTimer>
+#include <QHash>
+#include <QVector>
 #include <QMetaObject>
 #include <QMetaProperty>
 #include <QDateTime>
@@ -232,31 +238,6 @@ using namespace Amber;
 namespace {
     Q_LOGGING_CATEGORY(lcMetaData, "org.amber.mpris.metadata", QtWarningMsg)
 
-    const QString MetaFieldTrackId = QStringLiteral("mpris:trackid");
-    const QString MetaFieldLength = QStringLiteral("mpris:length");
-    const QString MetaFieldArtUrl = QStringLiteral("mpris:artUrl");
-    const QString MetaFieldAlbum = QStringLiteral("xesam:album");
-    const QString MetaFieldAlbumArtist = QStringLiteral("xesam:albumArtist");
-    const QString MetaFieldArtist = QStringLiteral("xesam:artist");
-    const QString MetaFieldAsText = QStringLiteral("xesam:asText");
-    const QString MetaFieldAudioBPM = QStringLiteral("xesam:audioBPM");
-    const QString MetaFieldAutoRating = QStringLiteral("xesam:autoRating");
-    const QString MetaFieldComment = QStringLiteral("xesam:comment");
-    const QString MetaFieldComposer = QStringLiteral("xesam:composer");
-    const QString MetaFieldContentCreated = QStringLiteral("xesam:contentCreated");
-    const QString MetaFieldDiscNumber = QStringLiteral("xesam:discNumber");
-    const QString MetaFieldFirstUsed = QStringLiteral("xesam:firstUsed");
-    const QString MetaFieldGenre = QStringLiteral("xesam:genre");
-    const QString MetaFieldLastUsed = QStringLiteral("xesam:lastUsed");
-    const QString MetaFieldLyricist = QStringLiteral("xesam:lyricist");
-    const QString MetaFieldTitle = QStringLiteral("xesam:title");
-    const QString MetaFieldTrackNumber = QStringLiteral("xesam:trackNumber");
-    const QString MetaFieldUrl = QStringLiteral("xesam:url");
-    const QString MetaFieldUseCount = QStringLiteral("xesam:useCount");
-    const QString MetaFieldUserRating = QStringLiteral("xesam:userRating");
-
-    const QString MetaFieldInternalYear = QStringLiteral("year");
-
     const QString NoTrackObjectPath = QStringLiteral("/org/mpris/MediaPlayer2/TrackList/NoTrack");
 
     bool validateTrackIdAsObjectPath(const QString &trackId)
@@ -296,41 +277,133 @@ namespace {
         return QVariant::fromValue(path);
     }
 
-    const QMap<QString, QVariant (*)(const QVariant &)> converters {
-        { MetaFieldTrackId, ensureType<QDBusObjectPath> },
-        { MetaFieldLength, ensureType<qint64> },
-        { MetaFieldArtUrl, ensureType<QString> },
-        { MetaFieldAlbum, ensureType<QString> },
-        { MetaFieldAlbumArtist, ensureType<QStringList> },
-        { MetaFieldArtist, ensureType<QStringList> },
-        { MetaFieldAsText, ensureType<QString> },
-        { MetaFieldAudioBPM, ensureType<qint32> },
-        { MetaFieldAutoRating, ensureType<double> },
-        { MetaFieldComment, ensureType<QString> },
-        { MetaFieldComposer, ensureType<QStringList> },
-        { MetaFieldContentCreated, ensureType<QDateTime> },
-        { MetaFieldDiscNumber, ensureType<qint32> },
-        { MetaFieldFirstUsed, ensureType<QDateTime> },
-        { MetaFieldGenre, ensureType<QStringList> },
-        { MetaFieldLastUsed, ensureType<QDateTime> },
-        { MetaFieldLyricist, ensureType<QStringList> },
-        { MetaFieldTitle, ensureType<QString> },
-        { MetaFieldTrackNumber, ensureType<qint32> },
-        { MetaFieldUrl, ensureType<QString> },
-        { MetaFieldUseCount, ensureType<qint32> },
-        { MetaFieldUserRating, ensureType<double> },
+    typedef void (MprisMetaData::*ChangeSignal)();
+
+    // In the order of the flags below
+    const ChangeSignal changeSignals[] = {
+        &MprisMetaData::trackIdChanged,
+        &MprisMetaData::durationChanged,
+        &MprisMetaData::artUrlChanged,
+        &MprisMetaData::albumTitleChanged,
+        &MprisMetaData::albumArtistChanged,
+        &MprisMetaData::contributingArtistChanged,
+        &MprisMetaData::lyricsChanged,
+        &MprisMetaData::audioBpmChanged,
+        &MprisMetaData::autoRatingChanged,
+        &MprisMetaData::commentChanged,
+        &MprisMetaData::composerChanged,
+        &MprisMetaData::yearChanged,
+        &MprisMetaData::dateChanged,
+        &MprisMetaData::discNumberChanged,
+        &MprisMetaData::firstUsedChanged,
+        &MprisMetaData::genreChanged,
+        &MprisMetaData::lastUsedChanged,
+        &MprisMetaData::writerChanged,
+        &MprisMetaData::titleChanged,
+        &MprisMetaData::trackNumberChanged,
+        &MprisMetaData::urlChanged,
+        &MprisMetaData::useCountChanged,
+        &MprisMetaData::userRatingChanged,
+        &MprisMetaData::extraFieldsChanged,
+    };
+    const int changeSignalCount = sizeof(changeSignals) / sizeof(changeSignals[0]);
+
+    enum Change : quint32 {
+        TrackIdChange = 1u << 0,
+        DurationChange = 1u << 1,
+        ArtUrlChange = 1u << 2,
+        AlbumTitleChange = 1u << 3,
+        AlbumArtistChange = 1u << 4,
+        ContributingArtistChange = 1u << 5,
+        LyricsChange = 1u << 6,
+        AudioBpmChange = 1u << 7,
+        AutoRatingChange = 1u << 8,
+        CommentChange = 1u << 9,
+        ComposerChange = 1u << 10,
+        YearChange = 1u << 11,
+        DateChange = 1u << 12,
+        DiscNumberChange = 1u << 13,
+        FirstUsedChange = 1u << 14,
+        GenreChange = 1u << 15,
+        LastUsedChange = 1u << 16,
+        WriterChange = 1u << 17,
+        TitleChange = 1u << 18,
+        TrackNumberChange = 1u << 19,
+        UrlChange = 1u << 20,
+        UseCountChange = 1u << 21,
+        UserRatingChange = 1u << 22,
+        ExtraFieldsChange = 1u << 23
+    };
+    Q_STATIC_ASSERT(ExtraFieldsChange == 1u << (changeSignalCount - 1));
+
+    struct FieldDescriptor {
+        const char *key;
+        QVariant (*convert)(const QVariant &);
+        quint32 changes;        // the properties reading the field
     };
+
+    // Indexed by MprisMetaDataPrivate::Field
+    constexpr FieldDescriptor fieldTable[] = {
+        { "mpris:trackid", ensureType<QDBusObjectPath>, TrackIdChange },
+        { "mpris:length", ensureType<qint64>, DurationChange },
+        { "mpris:artUrl", ensureType<QString>, ArtUrlChange },
+        { "xesam:album", ensureType<QString>, AlbumTitleChange },
+        { "xesam:albumArtist", ensureType<QStringList>, AlbumArtistChange },
+        { "xesam:artist", ensureType<QStringList>, ContributingArtistChange },
+        { "xesam:asText", ensureType<QString>, LyricsChange },
+        { "xesam:audioBPM", ensureType<qint32>, AudioBpmChange },
+        { "xesam:autoRating", ensureType<double>, AutoRatingChange },
+        { "xesam:comment", ensureType<QString>, CommentChange },
+        { "xesam:composer", ensureType<QStringList>, ComposerChange },
+        { "xesam:contentCreated", ensureType<QDateTime>, DateChange | YearChange },
+        { "xesam:discNumber", ensureType<qint32>, DiscNumberChange },
+        { "xesam:firstUsed", ensureType<QDateTime>, FirstUsedChange },
+        { "xesam:genre", ensureType<QStringList>, GenreChange },
+        { "xesam:lastUsed", ensureType<QDateTime>, LastUsedChange },
+        { "xesam:lyricist", ensureType<QStringList>, WriterChange },
+        { "xesam:title", ensureType<QString>, TitleChange },
+        { "xesam:trackNumber", ensureType<qint32>, TrackNumberChange },
+        { "xesam:url", ensureType<QString>, UrlChange },
+        { "xesam:useCount", ensureType<qint32>, UseCountChange },
+        { "xesam:userRating", ensureType<double>, UserRatingChange },
+        { "year", nullptr, YearChange },
+    };
+    Q_STATIC_ASSERT(sizeof(fieldTable) / sizeof(fieldTable[0]) == MprisMetaDataPrivate::FieldCount);
+
+    const QVector<QString> fieldKeys = [] {
+        QVector<QString> keys;
+        keys.reserve(MprisMetaDataPrivate::FieldCount);
+        for (const FieldDescriptor &field : fieldTable) {
+            keys.append(QString::fromLatin1(field.key));
+        }
+        return keys;
+    }();
+
+    const QHash<QString, int> fieldIndices = [] {
+        QHash<QString, int> indices;
+        for (int i = 0; i < fieldKeys.size(); ++i) {
+            indices.insert(fieldKeys.at(i), i);
+        }
+        return indices;
+    }();
+
+    bool isNamespaced(const QString &key)
+    {
+        return key.count(QLatin1Char(':')) == 1;
+    }
 }
 
 MprisMetaDataPrivate::MprisMetaDataPrivate(MprisMetaData *metaData)
     : QObject(metaData)
     , q_ptr(metaData)
+    , m_typedMetaDataValid(false)
+    , m_pendingChanges(0)
 {
     m_changedDelay.setInterval(50);
     m_changedDelay.setSingleShot(true);
     m_fillFromDelay.setInterval(10);
     m_fillFromDelay.setSingleShot(true);
-    connect(&m_changedDelay, &QTimer::timeout, this, [=] { Q_EMIT metaData->metaDataChanged(); });
+    connect(&m_changedDelay, &QTimer::timeout, this, &MprisMetaDataPrivate::emitPendingChanges);
     connect(&m_fillFromDelay, &QTimer::timeout, this, &MprisMetaDataPrivate::fillFrom);
 }
 
@@ -358,55 +431,142 @@ void MprisMetaDataPrivate::fillFrom()
     m_changedProperties.clear();
 }
 
+int MprisMetaDataPrivate::fieldIndex(const QString &key)
+{
+    return fieldIndices.value(key, -1);
+}
+
 QVariantMap MprisMetaDataPrivate::typedMetaData() const
 {
+    if (m_typedMetaDataValid) {
+        return m_typedMetaData;
+    }
+
     QVariantMap rv;
 
-    (void)m_metaData[MetaFieldTrackId];
-    for (auto c = m_metaData.cbegin();
-         c != m_metaData.cend();
-         ++c) {
-        if (converters.contains(c.key())) {
-            QVariant v = converters[c.key()](c.value());
+    for (int i = 0; i < YearField; ++i) {
+        if (m_fields[i].isValid()) {
+            QVariant v = fieldTable[i].convert(m_fields[i]);
             if (!v.isNull()) {
-                rv[c.key()] = v;
-            }
-        } else if (c.key() == MetaFieldInternalYear) {
-            if (!m_metaData.contains(MetaFieldContentCreated) || m_metaData[MetaFieldContentCreated].isNull()) {
-                QDateTime d = QDateTime::fromString(QStringLiteral("%1-01-02T00:00:00Z").arg(c.value().toString()), Qt::ISODate);
-                rv[MetaFieldContentCreated] = d.toString(Qt::ISODate);
+                rv.insert(fieldKeys.at(i), v);
             }
-        } else if (c.key().count(':') == 1) {
-            rv[c.key()] = c.value();
         }
     }
 
-    if (!rv.contains(MetaFieldTrackId)) {
-        rv[MetaFieldTrackId] = converters[MetaFieldTrackId](QVariant());
+    // The converter gives NoTrack for a missing id
+    rv.insert(fieldKeys.at(TrackIdField), fieldTable[TrackIdField].convert(m_fields[TrackIdField]));
+
+    if (m_fields[YearField].isValid() && m_fields[ContentCreatedField].isNull()) {
+        QDateTime d = QDateTime::fromString(QStringLiteral("%1-01-02T00:00:00Z").arg(m_fields[YearField].toString()), Qt::ISODate);
+        rv.insert(fieldKeys.at(ContentCreatedField), d.toString(Qt::ISODate));
+    }
+
+    for (auto c = m_extraFields.cbegin();
+         c != m_extraFields.cend();
+         ++c) {
+        if (isNamespaced(c.key())) {
+            rv.insert(c.key(), c.value());
+        }
     }
 
+    m_typedMetaData = rv;
+    m_typedMetaDataValid = true;
+
     return rv;
 }
 
-void MprisMetaDataPrivate::setMetaData(const QString &key, const QVariant &value)
+void MprisMetaDataPrivate::setField(Field field, const QVariant &value)
 {
     if (!value.isValid() || value.isNull()) {
-        if (!m_metaData.remove(key))
+        if (!m_fields[field].isValid())
             return;
-    } else if (m_metaData.value(key) != value) {
-        m_metaData[key] = value;
+        m_fields[field] = QVariant();
+    } else if (m_fields[field] != value) {
+        m_fields[field] = value;
     } else {
         return;
     }
+    m_typedMetaDataValid = false;
+    m_pendingChanges |= fieldTable[field].changes;
+    m_changedDelay.start();
+}
+
+void MprisMetaDataPrivate::setExtraField(const QString &key, const QVariant &value)
+{
+    if (!value.isValid() || value.isNull()) {
+        if (!m_extraFields.remove(key))
+            return;
+    } else if (m_extraFields.value(key) != value) {
+        m_extraFields[key] = value;
+    } else {
+        return;
+    }
+    m_typedMetaDataValid = false;
+    m_pendingChanges |= ExtraFieldsChange;
     m_changedDelay.start();
 }
 
 void MprisMetaDataPrivate::setMetaData(const QVariantMap &metaData)
 {
-    if (metaData != m_metaData) {
-        m_metaData = metaData;
-        Q_EMIT q_ptr->metaDataChanged();
+    QVariant fields[FieldCount];
+    QVariantMap extraFields;
+
+    for (auto c = metaData.cbegin();
+         c != metaData.cend();
+         ++c) {
+        const int field = fieldIndex(c.key());
+        if (field >= 0) {
+            fields[field] = c.value();
+        } else {
+            extraFields.insert(c.key(), c.value());
+        }
+    }
+
+    bool changed = false;
+    quint32 changes = 0;
+
+    for (int i = 0; i < FieldCount; ++i) {
+        if (fields[i] != m_fields[i]) {
+            changed = true;
+            changes |= fieldTable[i].changes;
+            m_fields[i] = fields[i];
+        }
+    }
+
+    if (extraFields != m_extraFields) {
+        changed = true;
+        changes |= ExtraFieldsChange;
+        m_extraFields = extraFields;
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    m_typedMetaDataValid = false;
+
+    // Folds in the changes of a pending delayed notification
+    m_pendingChanges |= changes;
+    m_changedDelay.stop();
+    emitPendingChanges();
+}
+
+void MprisMetaDataPrivate::emitChanges(quint32 changes)
+{
+    for (int i = 0; i < changeSignalCount; ++i) {
+        if (changes & (1u << i)) {
+            Q_EMIT (q_ptr->*changeSignals[i])();
+        }
     }
+
+    Q_EMIT q_ptr->metaDataChanged();
+}
+
+void MprisMetaDataPrivate::emitPendingChanges()
+{
+    const quint32 changes = m_pendingChanges;
+    m_pendingChanges = 0;
+    emitChanges(changes);
 }
 
 MprisMetaData::MprisMetaData(QObject *parent)
@@ -421,11 +581,7 @@ MprisMetaData::~MprisMetaData()
 
 QVariant MprisMetaData::trackId() const
 {
-    if (priv->m_metaData.contains(MetaFieldTrackId)) {
-        return priv->m_metaData[MetaFieldTrackId];
-    }
-
-    return QVariant();
+    return priv->m_fields[MprisMetaDataPrivate::TrackIdField];
 }
 
 void MprisMetaData::setTrackId(const QVariant &trackId)
@@ -444,13 +600,14 @@ void MprisMetaData::setTrackId(const QVariant &trackId)
         else
             value = id;
     }
-    priv->setMetaData(MetaFieldTrackId, value);
+    priv->setField(MprisMetaDataPrivate::TrackIdField, value);
 }
 
 QVariant MprisMetaData::duration() const
 {
-    if (priv->m_metaData.contains(MetaFieldLength)) {
-        return qvariant_cast<qint64>(priv->m_metaData[MetaFieldLength]) / 1000;
+    const QVariant &length = priv->m_fields[MprisMetaDataPrivate::LengthField];
+    if (length.isValid()) {
+        return qvariant_cast<qint64>(length) / 1000;
     }
 
     return QVariant();
@@ -459,89 +616,90 @@ QVariant MprisMetaData::duration() const
 void MprisMetaData::setDuration(const QVariant &duration)
 {
     if (duration.toLongLong() <= 0)
-        priv->setMetaData(MetaFieldLength, QVariant());
+        priv->setField(MprisMetaDataPrivate::LengthField, QVariant());
     else
-        priv->setMetaData(MetaFieldLength, duration.toLongLong() * 1000);
+        priv->setField(MprisMetaDataPrivate::LengthField, duration.toLongLong() * 1000);
 }
 
 QVariant MprisMetaData::artUrl() const
 {
-    return priv->m_metaData.value(MetaFieldArtUrl);
+    return priv->m_fields[MprisMetaDataPrivate::ArtUrlField];
 }
 
 void MprisMetaData::setArtUrl(const QVariant &url)
 {
-    priv->setMetaData(MetaFieldArtUrl, url);
+    priv->setField(MprisMetaDataPrivate::ArtUrlField, url);
 }
 
 QVariant MprisMetaData::contributingArtist() const
 {
-    return priv->m_metaData.value(MetaFieldArtist);
+    return priv->m_fields[MprisMetaDataPrivate::ArtistField];
 }
 
 void MprisMetaData::setContributingArtist(const QVariant &artist)
 {
-    priv->setMetaData(MetaFieldArtist, artist);
+    priv->setField(MprisMetaDataPrivate::ArtistField, artist);
 }
 
 QVariant MprisMetaData::albumTitle() const
 {
-    return priv->m_metaData.value(MetaFieldAlbum);
+    return priv->m_fields[MprisMetaDataPrivate::AlbumField];
 }
 
 void MprisMetaData::setAlbumTitle(const QVariant &title)
 {
-    priv->setMetaData(MetaFieldAlbum, title);
+    priv->setField(MprisMetaDataPrivate::AlbumField, title);
 }
 
 QVariant MprisMetaData::albumArtist() const
 {
-    return priv->m_metaData.value(MetaFieldAlbumArtist);
+    return priv->m_fields[MprisMetaDataPrivate::AlbumArtistField];
 }
 
 void MprisMetaData::setAlbumArtist(const QVariant &artist)
 {
-    priv->setMetaData(MetaFieldAlbumArtist, artist);
+    priv->setField(MprisMetaDataPrivate::AlbumArtistField, artist);
 }
 
 QVariant MprisMetaData::lyrics() const
 {
-    return priv->m_metaData.value(MetaFieldAsText);
+    return priv->m_fields[MprisMetaDataPrivate::AsTextField];
 }
 
 void MprisMetaData::setLyrics(const QVariant &lyrics)
 {
-    priv->setMetaData(MetaFieldAsText, lyrics);
+    priv->setField(MprisMetaDataPrivate::AsTextField, lyrics);
 }
 
 QVariant MprisMetaData::comment() const
 {
-    return priv->m_metaData.value(MetaFieldComment);
+    return priv->m_fields[MprisMetaDataPrivate::CommentField];
 }
 
 void MprisMetaData::setComment(const QVariant &comment)
 {
-    priv->setMetaData(MetaFieldComment, comment);
+    priv->setField(MprisMetaDataPrivate::CommentField, comment);
 }
 
 QVariant MprisMetaData::composer() const
 {
-    return priv->m_metaData.value(MetaFieldComposer);
+    return priv->m_fields[MprisMetaDataPrivate::ComposerField];
 }
 
 void MprisMetaData::setComposer(const QVariant &composer)
 {
-    priv->setMetaData(MetaFieldComposer, composer);
+    priv->setField(MprisMetaDataPrivate::ComposerField, composer);
 }
 
 QVariant MprisMetaData::year() const
 {
-    if (priv->m_metaData.contains(MetaFieldInternalYear)) {
-        return priv->m_metaData[MetaFieldInternalYear];
+    const QVariant &year = priv->m_fields[MprisMetaDataPrivate::YearField];
+    if (year.isValid()) {
+        return year;
     }
-    if (priv->m_metaData.contains(MetaFieldContentCreated) &&
-        priv->m_metaData[MetaFieldContentCreated].isValid()) {
-        QDateTime d = QDateTime::fromString(priv->m_metaData[MetaFieldContentCreated].toString(), Qt::ISODate);
+    const QVariant &created = priv->m_fields[MprisMetaDataPrivate::ContentCreatedField];
+    if (created.isValid()) {
+        QDateTime d = QDateTime::fromString(created.toString(), Qt::ISODate);
         return d.date().year();
     }
 
@@ -550,140 +708,141 @@ QVariant MprisMetaData::year() const
 
 void MprisMetaData::setYear(const QVariant &year)
 {
-    priv->setMetaData(MetaFieldInternalYear, year);
+    priv->setField(MprisMetaDataPrivate::YearField, year);
 }
 
 QVariant MprisMetaData::date() const
 {
-    if (priv->m_metaData.contains(MetaFieldContentCreated)) {
-        return QDateTime::fromString(priv->m_metaData[MetaFieldContentCreated].toString(), Qt::ISODate);
+    const QVariant &created = priv->m_fields[MprisMetaDataPrivate::ContentCreatedField];
+    if (created.isValid()) {
+        return QDateTime::fromString(created.toString(), Qt::ISODate);
     }
     return QVariant();
 }
 
 void MprisMetaData::setDate(const QVariant &date)
 {
-    priv->setMetaData(MetaFieldContentCreated, date);
+    priv->setField(MprisMetaDataPrivate::ContentCreatedField, date);
 }
 
 QVariant MprisMetaData::discNumber() const
 {
-    return priv->m_metaData.value(MetaFieldDiscNumber);
+    return priv->m_fields[MprisMetaDataPrivate::DiscNumberField];
 }
 
 void MprisMetaData::setDiscNumber(const QVariant &chapter)
 {
-    priv->setMetaData(MetaFieldDiscNumber, chapter);
+    priv->setField(MprisMetaDataPrivate::DiscNumberField, chapter);
 }
 
 QVariant MprisMetaData::genre() const
 {
-    return priv->m_metaData.value(MetaFieldGenre);
+    return priv->m_fields[MprisMetaDataPrivate::GenreField];
 }
 
 void MprisMetaData::setGenre(const QVariant &genre)
 {
-    priv->setMetaData(MetaFieldGenre, genre);
+    priv->setField(MprisMetaDataPrivate::GenreField, genre);
 }
 
 QVariant MprisMetaData::writer() const
 {
-    return priv->m_metaData.value(MetaFieldLyricist);
+    return priv->m_fields[MprisMetaDataPrivate::LyricistField];
 }
 
 void MprisMetaData::setWriter(const QVariant &writer)
 {
-    priv->setMetaData(MetaFieldLyricist, writer);
+    priv->setField(MprisMetaDataPrivate::LyricistField, writer);
 }
 
 QVariant MprisMetaData::title() const
 {
-    return priv->m_metaData.value(MetaFieldTitle);
+    return priv->m_fields[MprisMetaDataPrivate::TitleField];
 }
 
 void MprisMetaData::setTitle(const QVariant &title)
 {
-    priv->setMetaData(MetaFieldTitle, title);
+    priv->setField(MprisMetaDataPrivate::TitleField, title);
 }
 
 QVariant MprisMetaData::trackNumber() const
 {
-    return priv->m_metaData.value(MetaFieldTrackNumber);
+    return priv->m_fields[MprisMetaDataPrivate::TrackNumberField];
 }
 
 void MprisMetaData::setTrackNumber(const QVariant &track)
 {
-    priv->setMetaData(MetaFieldTrackNumber, track);
+    priv->setField(MprisMetaDataPrivate::TrackNumberField, track);
 }
 
 QVariant MprisMetaData::userRating() const
 {
-    return priv->m_metaData.value(MetaFieldUserRating);
+    return priv->m_fields[MprisMetaDataPrivate::UserRatingField];
 }
 
 void MprisMetaData::setUserRating(const QVariant &rating)
 {
-    priv->setMetaData(MetaFieldUserRating, rating);
+    priv->setField(MprisMetaDataPrivate::UserRatingField, rating);
 }
 
 QVariant MprisMetaData::audioBpm() const
 {
-    return priv->m_metaData.value(MetaFieldAudioBPM);
+    return priv->m_fields[MprisMetaDataPrivate::AudioBpmField];
 }
 
 void MprisMetaData::setAudioBpm(const QVariant &bpm)
 {
-    priv->setMetaData(MetaFieldAudioBPM, bpm);
+    priv->setField(MprisMetaDataPrivate::AudioBpmField, bpm);
 }
 
 QVariant MprisMetaData::autoRating() const
 {
-    return priv->m_metaData.value(MetaFieldAutoRating);
+    return priv->m_fields[MprisMetaDataPrivate::AutoRatingField];
 }
 
 void MprisMetaData::setAutoRating(const QVariant &rating)
 {
-    priv->setMetaData(MetaFieldAutoRating, rating);
+    priv->setField(MprisMetaDataPrivate::AutoRatingField, rating);
 }
 
 QVariant MprisMetaData::firstUsed() const
 {
-    return priv->m_metaData.value(MetaFieldFirstUsed);
+    return priv->m_fields[MprisMetaDataPrivate::FirstUsedField];
 }
 
 void MprisMetaData::setFirstUsed(const QVariant &used)
 {
-    priv->setMetaData(MetaFieldFirstUsed, used);
+    priv->setField(MprisMetaDataPrivate::FirstUsedField, used);
 }
 
 QVariant MprisMetaData::lastUsed() const
 {
-    return priv->m_metaData.value(MetaFieldLastUsed);
+    return priv->m_fields[MprisMetaDataPrivate::LastUsedField];
 }
 
 void MprisMetaData::setLastUsed(const QVariant &used)
 {
-    priv->setMetaData(MetaFieldLastUsed, used);
+    priv->setField(MprisMetaDataPrivate::LastUsedField, used);
 }
 
 QVariant MprisMetaData::url() const
 {
-    return priv->m_metaData.value(MetaFieldUrl);
+    return priv->m_fields[MprisMetaDataPrivate::UrlField];
 }
 
 void MprisMetaData::setUrl(const QVariant &url)
 {
-    priv->setMetaData(MetaFieldUrl, url);
+    priv->setField(MprisMetaDataPrivate::UrlField, url);
 }
 
 QVariant MprisMetaData::useCount() const
 {
-    return priv->m_metaData.value(MetaFieldUseCount);
+    return priv->m_fields[MprisMetaDataPrivate::UseCountField];
 }
 
 void MprisMetaData::setUseCount(const QVariant &count)
 {
-    priv->setMetaData(MetaFieldUseCount, count);
+    priv->setField(MprisMetaDataPrivate::UseCountField, count);
 }
 
 void MprisMetaData::setFillFrom(const QVariant &fillFrom)
@@ -753,10 +912,10 @@ QVariantMap MprisMetaData::extraFields() const
 {
     QVariantMap rv;
 
-    for (auto c = priv->m_metaData.cbegin();
-         c != priv->m_metaData.cend();
+    for (auto c = priv->m_extraFields.cbegin();
+         c != priv->m_extraFields.cend();
          ++c) {
-        if (c.key().count(':') == 1 && !converters.contains(c.key())) { // MetaFieldInternalYear has no namespace
+        if (isNamespaced(c.key())) {
             rv[c.key()] = c.value();
         }
     }
@@ -766,11 +925,7 @@ QVariantMap MprisMetaData::extraFields() const
 
 QVariant MprisMetaData::extraField(const QString &key) const
 {
-    if (priv->m_metaData.contains(key) && !converters.contains(key) && key != MetaFieldInternalYear) {
-        return priv->m_metaData[key];
-    } else {
-        return QVariant();
-    }
+    return priv->m_extraFields.value(key);
 }
 
 void MprisMetaData::setExtraFields(const QVariantMap &fields)
@@ -784,7 +939,7 @@ void MprisMetaData::setExtraFields(const QVariantMap &fields)
 
 void MprisMetaData::setExtraField(const QString &key, const QVariant &value)
 {
-    if (!converters.contains(key) && key.count(':') == 1) {
-        priv->setMetaData(key, value);
+    if (isNamespaced(key) && MprisMetaDataPrivate::fieldIndex(key) < 0) {
+        priv->setExtraField(key, value);
     }
 }
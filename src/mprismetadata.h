@@ -37,31 +37,31 @@ class MprisMetaDataPrivate;
 class AMBER_MPRIS_EXPORT MprisMetaData : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(QVariant trackId READ trackId WRITE setTrackId NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant duration READ duration WRITE setDuration NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant artUrl READ artUrl WRITE setArtUrl NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant albumTitle READ albumTitle WRITE setAlbumTitle NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant albumArtist READ albumArtist WRITE setAlbumArtist NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant contributingArtist READ contributingArtist WRITE setContributingArtist NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant lyrics READ lyrics WRITE setLyrics NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant audioBpm READ audioBpm WRITE setAudioBpm NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant autoRating READ autoRating WRITE setAutoRating NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant comment READ comment WRITE setComment NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant composer READ composer WRITE setComposer NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant year READ year WRITE setYear NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant date READ date WRITE setDate NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant discNumber READ discNumber WRITE setDiscNumber NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant firstUsed READ firstUsed WRITE setFirstUsed NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant genre READ genre WRITE setGenre NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant lastUsed READ lastUsed WRITE setLastUsed NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant writer READ writer WRITE setWriter NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant title READ title WRITE setTitle NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant trackNumber READ trackNumber WRITE setTrackNumber NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant url READ url WRITE setUrl NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant useCount READ useCount WRITE setUseCount NOTIFY metaDataChanged)
-    Q_PROPERTY(QVariant userRating READ userRating WRITE setUserRating NOTIFY metaDataChanged)
-
-    Q_PROPERTY(QVariantMap extraFields READ extraFields WRITE setExtraFields NOTIFY metaDataChanged)
+    Q_PROPERTY(QVariant trackId READ trackId WRITE setTrackId NOTIFY trackIdChanged)
+    Q_PROPERTY(QVariant duration READ duration WRITE setDuration NOTIFY durationChanged)
+    Q_PROPERTY(QVariant artUrl READ artUrl WRITE setArtUrl NOTIFY artUrlChanged)
+    Q_PROPERTY(QVariant albumTitle READ albumTitle WRITE setAlbumTitle NOTIFY albumTitleChanged)
+    Q_PROPERTY(QVariant albumArtist READ albumArtist WRITE setAlbumArtist NOTIFY albumArtistChanged)
+    Q_PROPERTY(QVariant contributingArtist READ contributingArtist WRITE setContributingArtist NOTIFY contributingArtistChanged)
+    Q_PROPERTY(QVariant lyrics READ lyrics WRITE setLyrics NOTIFY lyricsChanged)
+    Q_PROPERTY(QVariant audioBpm READ audioBpm WRITE setAudioBpm NOTIFY audioBpmChanged)
+    Q_PROPERTY(QVariant autoRating READ autoRating WRITE setAutoRating NOTIFY autoRatingChanged)
+    Q_PROPERTY(QVariant comment READ comment WRITE setComment NOTIFY commentChanged)
+    Q_PROPERTY(QVariant composer READ composer WRITE setComposer NOTIFY composerChanged)
+    Q_PROPERTY(QVariant year READ year WRITE setYear NOTIFY yearChanged)
+    Q_PROPERTY(QVariant date READ date WRITE setDate NOTIFY dateChanged)
+    Q_PROPERTY(QVariant discNumber READ discNumber WRITE setDiscNumber NOTIFY discNumberChanged)
+    Q_PROPERTY(QVariant firstUsed READ firstUsed WRITE setFirstUsed NOTIFY firstUsedChanged)
+    Q_PROPERTY(QVariant genre READ genre WRITE setGenre NOTIFY genreChanged)
+    Q_PROPERTY(QVariant lastUsed READ lastUsed WRITE setLastUsed NOTIFY lastUsedChanged)
+    Q_PROPERTY(QVariant writer READ writer WRITE setWriter NOTIFY writerChanged)
+    Q_PROPERTY(QVariant title READ title WRITE setTitle NOTIFY titleChanged)
+    Q_PROPERTY(QVariant trackNumber READ trackNumber WRITE setTrackNumber NOTIFY trackNumberChanged)
+    Q_PROPERTY(QVariant url READ url WRITE setUrl NOTIFY urlChanged)
+    Q_PROPERTY(QVariant useCount READ useCount WRITE setUseCount NOTIFY useCountChanged)
+    Q_PROPERTY(QVariant userRating READ userRating WRITE setUserRating NOTIFY userRatingChanged)
+
+    Q_PROPERTY(QVariantMap extraFields READ extraFields WRITE setExtraFields NOTIFY extraFieldsChanged)
     Q_PROPERTY(QVariant fillFrom READ fillFrom WRITE setFillFrom NOTIFY fillFromChanged)
 
 public:
@@ -135,6 +135,31 @@ Q_SIGNALS:
     void metaDataChanged();
     void fillFromChanged();
 
+    void trackIdChanged();
+    void durationChanged();
+    void artUrlChanged();
+    void albumTitleChanged();
+    void albumArtistChanged();
+    void contributingArtistChanged();
+    void lyricsChanged();
+    void audioBpmChanged();
+    void autoRatingChanged();
+    void commentChanged();
+    void composerChanged();
+    void yearChanged();
+    void dateChanged();
+    void discNumberChanged();
+    void firstUsedChanged();
+    void genreChanged();
+    void lastUsedChanged();
+    void writerChanged();
+    void titleChanged();
+    void trackNumberChanged();
+    void urlChanged();
+    void useCountChanged();
+    void userRatingChanged();
+    void extraFieldsChanged();
+
 private:
     MprisMetaDataPrivate *priv;
     friend class MprisPlayerPrivate;
@@ -37,18 +37,58 @@ public:
     MprisMetaDataPrivate(MprisMetaData *metaData);
     ~MprisMetaDataPrivate();
 
+    // The well known fields, in the order of the field table. Everything
+    // else is kept in the extra fields.
+    enum Field {
+        TrackIdField,
+        LengthField,
+        ArtUrlField,
+        AlbumField,
+        AlbumArtistField,
+        ArtistField,
+        AsTextField,
+        AudioBpmField,
+        AutoRatingField,
+        CommentField,
+        ComposerField,
+        ContentCreatedField,
+        DiscNumberField,
+        FirstUsedField,
+        GenreField,
+        LastUsedField,
+        LyricistField,
+        TitleField,
+        TrackNumberField,
+        UrlField,
+        UseCountField,
+        UserRatingField,
+        YearField,              // internal, merged into contentCreated on the wire
+        FieldCount
+    };
+
+    static int fieldIndex(const QString &key);
+
+    // Cached until a field actually changes
     QVariantMap typedMetaData() const;
-    void setMetaData(const QString &key, const QVariant &value);
+    void setField(Field field, const QVariant &value);
+    void setExtraField(const QString &key, const QVariant &value);
     void setMetaData(const QVariantMap &metaData);
 
+    void emitChanges(quint32 changes);
+
 public Q_SLOTS:
     void fillFromPropertyChange();
     void fillFrom();
+    void emitPendingChanges();
 
 public:
     MprisMetaData *q_ptr;
-    QVariantMap m_metaData;
+    QVariant m_fields[FieldCount];
+    QVariantMap m_extraFields;
+    mutable QVariantMap m_typedMetaData;
+    mutable bool m_typedMetaDataValid;
     QTimer m_changedDelay;
+    quint32 m_pendingChanges;
     QTimer m_fillFromDelay;
     QVariant m_fillFrom;
     QPointer<QObject> m_fillFromObject;
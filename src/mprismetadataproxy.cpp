@@ -1,6 +1,7 @@
 #include "mprismetadataproxy.h"
 
 #include <QDebug>
+#include <QMetaProperty>
 
 MprisMetaDataProxy::MprisMetaDataProxy(QObject *parent)
     : Amber::MprisMetaData(parent)
@@ -352,10 +353,36 @@ void MprisMetaDataProxy::setTarget(Amber::MprisMetaData *target)
         return;
     }
 
+    // Only the properties that differ between the targets get notified,
+    // e.g. switching between players showing the same art doesn't reload it
+    const QMetaObject *meta = &Amber::MprisMetaData::staticMetaObject;
+    QList<QMetaProperty> properties;
+    QVariantList oldValues;
+    for (int i = meta->propertyOffset(); i < meta->propertyCount(); ++i) {
+        QMetaProperty property = meta->property(i);
+        if (property.hasNotifySignal() && QLatin1String("fillFrom") != property.name()) {
+            properties.append(property);
+            oldValues.append(property.read(this));
+        }
+    }
+
+    if (m_target.data()) {
+        m_target->disconnect(this);
+    }
+
     m_target = target;
     if (m_target.data()) {
         connect(m_target.data(), &Amber::MprisMetaData::metaDataChanged,
                 this, &Amber::MprisMetaData::metaDataChanged);
+        for (const QMetaProperty &property : qAsConst(properties)) {
+            connect(m_target.data(), property.notifySignal(), this, property.notifySignal());
+        }
+    }
+
+    for (int i = 0; i < properties.count(); ++i) {
+        if (properties.at(i).read(this) != oldValues.at(i)) {
+            properties.at(i).notifySignal().invoke(this, Qt::DirectConnection);
+        }
     }
 
     metaDataChanged();
@@ -26,6 +26,7 @@
 #include "ambermpris_p.h"
 #include "mpris_p.h"
 
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 
 using namespace Amber;
@@ -36,12 +37,37 @@ namespace {
     const QString TrackPrefix = QStringLiteral("/org/mpris/MediaPlayer2/TrackList/");
 
     Q_LOGGING_CATEGORY(lcPlayer, "org.amber.mpris.player", QtWarningMsg)
+
+    // PropertiesChanged scheduling, in milliseconds. Urgent changes go out
+    // right away, the rest are batched until the changes settle but never
+    // for longer than the maximum latency. Consecutive signals are spaced
+    // by the minimum gap.
+    const qint64 ChangedBatchDelay = 50;
+    const qint64 ChangedMaximumLatency = 250;
+    const qint64 ChangedMinimumGap = 20;
+
+    qint64 monotonicNow()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        return timer.msecsSinceReference();
+    }
+
+    bool isUrgentChange(const QString &name)
+    {
+        return name == QLatin1String("PlaybackStatus")
+                || name == QLatin1String("CanPlay")
+                || name == QLatin1String("CanPause");
+    }
+
+    bool s_serviceThreadEnabled = false;
 }
 
 MprisPlayerPrivate::MprisPlayerPrivate(MprisPlayer *parent)
     : QObject(parent)
     , q_ptr(parent)
     , m_connection(nullptr)
+    , m_service(nullptr)
     , m_serviceAdaptor(this)
     , m_playerAdaptor(this)
     , m_playerPropertiesAdaptor(this)
@@ -51,6 +77,11 @@ MprisPlayerPrivate::MprisPlayerPrivate(MprisPlayer *parent)
     , m_canSetFullscreen(false)
     , m_fullscreen(false)
     , m_hasTrackList(false)
+    , m_firstChange(-1)
+    , m_changedDue(0)
+    , m_lastChangedSignal(-ChangedMinimumGap)
+    , m_urgentChangePending(false)
+    , m_changedStatistics()
     , m_metaData(this)
     , m_canControl(false)
     , m_canGoNext(false)
@@ -69,13 +100,31 @@ MprisPlayerPrivate::MprisPlayerPrivate(MprisPlayer *parent)
     , m_shuffle(false)
     , m_volume(0.0)
     , m_inPositionRequested(false)
-{
+    , m_hasPositionSnapshot(false)
+    , m_snapshotPosition(0)
+    , m_snapshotTime(0)
+    , m_propertiesGeneration(0)
+    , m_coalescingWindow(0)
+    , m_hasPendingSeek(false)
+    , m_pendingSeek(0)
+    , m_hasPendingPosition(false)
+    , m_pendingPosition(0)
+    , m_hasPendingRate(false)
+    , m_pendingRate(1.0)
+    , m_hasPendingVolume(false)
+    , m_pendingVolume(0.0)
+{
+    m_changedClock.start();
+
     m_changedDelay.setSingleShot(true);
-    m_changedDelay.setInterval(50);
+    m_changedDelay.setTimerType(Qt::PreciseTimer);
+
+    m_coalescingDelay.setSingleShot(true);
 
     qDBusRegisterMetaType<QStringList>();
     connect(&m_metaData, &MprisMetaData::metaDataChanged, this, [this] { propertyChanged(PlayerInterface, QStringLiteral("Metadata"), metaData()); });
     connect(&m_changedDelay, &QTimer::timeout, this, &MprisPlayerPrivate::emitPropertiesChanged);
+    connect(&m_coalescingDelay, &QTimer::timeout, this, &MprisPlayerPrivate::emitPendingRequests);
 }
 
 MprisPlayerPrivate::~MprisPlayerPrivate()
@@ -86,6 +135,11 @@ MprisPlayerPrivate::~MprisPlayerPrivate()
         QDBusConnection::disconnectFromBus(m_connection->name());
         delete m_connection;
     }
+
+    if (m_service) {
+        // Calls already queued to the service thread are handled first
+        m_service->deleteLater();
+    }
 }
 
 void MprisPlayerPrivate::quit()
@@ -100,9 +154,28 @@ void MprisPlayerPrivate::raise()
 
 qlonglong MprisPlayerPrivate::position() const
 {
+    if (m_hasPositionSnapshot) {
+        return extrapolatedPosition() * 1000;
+    }
     return q_ptr->position() * 1000;
 }
 
+qlonglong MprisPlayerPrivate::extrapolatedPosition() const
+{
+    return MprisPlayerState::extrapolate(m_snapshotPosition, m_snapshotTime,
+                                         m_playbackStatus == Mpris::Playing, m_rate,
+                                         m_metaData.duration().toLongLong());
+}
+
+void MprisPlayerPrivate::rebasePositionSnapshot()
+{
+    // Keeps the part played so far from being extrapolated with new values
+    if (m_hasPositionSnapshot) {
+        m_snapshotPosition = extrapolatedPosition();
+        m_snapshotTime = monotonicNow();
+    }
+}
+
 void MprisPlayerPrivate::setLoopStatus(const QString &value)
 {
     Mpris::LoopStatus enumVal;
@@ -134,7 +207,7 @@ void MprisPlayerPrivate::setRate(double rate)
     } else if (rate < q_ptr->minimumRate() || rate > q_ptr->maximumRate()) {
         sendErrorReply(QDBusError::InvalidArgs, QStringLiteral("Rate not in the allowed range"));
     } else {
-        Q_EMIT q_ptr->rateRequested(rate);
+        requestRate(rate);
     }
 }
 
@@ -152,7 +225,7 @@ void MprisPlayerPrivate::setVolume(double volume)
     if (!q_ptr->canControl()) {
         sendErrorReply(QDBusError::NotSupported, QStringLiteral("The operation is not supported"));
     } else {
-        Q_EMIT q_ptr->volumeRequested(volume);
+        requestVolume(volume);
     }
 }
 
@@ -227,7 +300,7 @@ void MprisPlayerPrivate::Seek(qlonglong Offset)
     } else if (!q_ptr->canSeek()) {
         sendErrorReply(QDBusError::Failed, QStringLiteral("The operation can not be performed"));
     } else {
-        Q_EMIT q_ptr->seekRequested(Offset / 1000);
+        requestSeek(Offset / 1000);
     }
 }
 
@@ -238,7 +311,7 @@ void MprisPlayerPrivate::SetPosition(const QDBusObjectPath &TrackId, qlonglong p
     } else if (!q_ptr->canSeek()) {
         sendErrorReply(QDBusError::Failed, QStringLiteral("The operation can not be performed"));
     } else {
-        Q_EMIT q_ptr->setPositionRequested(TrackId.path(), position / 1000);
+        requestPosition(TrackId.path(), position / 1000);
     }
 }
 
@@ -308,9 +381,13 @@ void MprisPlayerPrivate::setFullscreen(bool value)
 
 void MprisPlayerPrivate::propertyChanged(const QString &iface, const QString &name, const QVariant &value)
 {
+    ++m_propertiesGeneration;
+
     if (!m_connection)
         return;
 
+    publishState();
+
     if (!value.isValid()) {
         m_changedProperties[iface].first.remove(name);
         m_changedProperties[iface].second << name;
@@ -319,7 +396,234 @@ void MprisPlayerPrivate::propertyChanged(const QString &iface, const QString &na
         m_changedProperties[iface].second.remove(name);
     }
 
-    m_changedDelay.start();
+    const qint64 now = m_changedClock.elapsed();
+    const bool urgent = isUrgentChange(name);
+
+    if (m_firstChange < 0) {
+        m_firstChange = now;
+    }
+
+    // Batched changes push the signal out until the deadline, but never
+    // past an urgent change already waiting
+    qint64 due = urgent ? now : qMin(now + ChangedBatchDelay, m_firstChange + ChangedMaximumLatency);
+    if (m_urgentChangePending) {
+        due = qMin(due, m_changedDue);
+    }
+    due = qMax(due, m_lastChangedSignal + ChangedMinimumGap);
+
+    m_urgentChangePending = m_urgentChangePending || urgent;
+    m_changedDue = due;
+    m_changedDelay.start(int(qMax<qint64>(0, due - now)));
+}
+
+void MprisPlayerPrivate::cancelPropertiesChanged()
+{
+    m_changedDelay.stop();
+    m_changedProperties.clear();
+    m_firstChange = -1;
+    m_urgentChangePending = false;
+}
+
+void MprisPlayerPrivate::publishState()
+{
+    if (!m_service)
+        return;
+
+    std::shared_ptr<MprisPlayerState> state = std::make_shared<MprisPlayerState>();
+
+    state->playerProperties = m_playerPropertiesAdaptor.cachedProperties(PlayerInterface);
+    state->serviceProperties = m_playerPropertiesAdaptor.cachedProperties(ServiceInterface);
+    state->maskedProperties = m_playerPropertiesAdaptor.maskedProperties();
+    state->interfaceXml = m_playerIntrospectableAdaptor.interfaceXml();
+    state->propertiesLocked = m_playerPropertiesAdaptor.propertiesLocked();
+
+    state->canControl = q_ptr->canControl();
+    state->canGoNext = q_ptr->canGoNext();
+    state->canGoPrevious = q_ptr->canGoPrevious();
+    state->canPause = q_ptr->canPause();
+    state->canPlay = q_ptr->canPlay();
+    state->canSeek = q_ptr->canSeek();
+    state->minimumRate = m_minimumRate;
+    state->maximumRate = m_maximumRate;
+
+    state->hasPositionSnapshot = m_hasPositionSnapshot;
+    state->position = m_hasPositionSnapshot ? m_snapshotPosition : m_position;
+    state->positionTime = m_snapshotTime;
+    state->playing = m_playbackStatus == Mpris::Playing;
+    state->rate = m_rate;
+    state->duration = m_metaData.duration().toLongLong();
+
+    m_service->publish(state);
+}
+
+void MprisPlayerPrivate::onServiceRequest(int request, const QVariant &argument, const QVariant &secondArgument)
+{
+    // Already validated by the service, against the last published state
+    switch (request) {
+    case MprisPlayerService::Quit:
+        quit();
+        break;
+    case MprisPlayerService::Raise:
+        raise();
+        break;
+    case MprisPlayerService::SetFullscreen:
+        setFullscreen(argument.toBool());
+        break;
+    case MprisPlayerService::Next:
+        Q_EMIT q_ptr->nextRequested();
+        break;
+    case MprisPlayerService::OpenUri:
+        Q_EMIT q_ptr->openUriRequested(QUrl::fromUserInput(argument.toString()));
+        break;
+    case MprisPlayerService::Pause:
+        Q_EMIT q_ptr->pauseRequested();
+        break;
+    case MprisPlayerService::Play:
+        Q_EMIT q_ptr->playRequested();
+        break;
+    case MprisPlayerService::PlayPause:
+        Q_EMIT q_ptr->playPauseRequested();
+        break;
+    case MprisPlayerService::Previous:
+        Q_EMIT q_ptr->previousRequested();
+        break;
+    case MprisPlayerService::Seek:
+        requestSeek(argument.toLongLong() / 1000);
+        break;
+    case MprisPlayerService::SetPosition:
+        requestPosition(argument.toString(), secondArgument.toLongLong() / 1000);
+        break;
+    case MprisPlayerService::Stop:
+        Q_EMIT q_ptr->stopRequested();
+        break;
+    case MprisPlayerService::SetLoopStatus:
+        Q_EMIT q_ptr->loopStatusRequested(argument.toInt());
+        break;
+    case MprisPlayerService::SetRate:
+        requestRate(argument.toDouble());
+        break;
+    case MprisPlayerService::SetShuffle:
+        Q_EMIT q_ptr->shuffleRequested(argument.toBool());
+        break;
+    case MprisPlayerService::SetVolume:
+        requestVolume(argument.toDouble());
+        break;
+    case MprisPlayerService::LockProperties:
+        if (!m_playerPropertiesAdaptor.propertiesLocked()) {
+            m_playerPropertiesAdaptor.lockProperties();
+            publishState();
+        }
+        break;
+    default:
+        qCWarning(lcPlayer) << "Unknown service request" << request;
+        break;
+    }
+}
+
+void MprisPlayerPrivate::requestSeek(qlonglong offset)
+{
+    if (m_coalescingWindow <= 0) {
+        Q_EMIT q_ptr->seekRequested(offset);
+        return;
+    }
+
+    if (m_hasPendingPosition) {
+        // Relative to the position already asked for
+        m_pendingPosition = qMax<qlonglong>(0, m_pendingPosition + offset);
+    } else {
+        m_pendingSeek += offset;
+        m_hasPendingSeek = true;
+    }
+
+    if (!m_coalescingDelay.isActive()) {
+        m_coalescingDelay.start(m_coalescingWindow);
+    }
+}
+
+void MprisPlayerPrivate::requestPosition(const QString &trackId, qlonglong position)
+{
+    if (m_coalescingWindow <= 0) {
+        Q_EMIT q_ptr->setPositionRequested(trackId, position);
+        return;
+    }
+
+    // An absolute position overrides the seeks before it
+    m_hasPendingSeek = false;
+    m_pendingSeek = 0;
+    m_hasPendingPosition = true;
+    m_pendingTrackId = trackId;
+    m_pendingPosition = position;
+
+    if (!m_coalescingDelay.isActive()) {
+        m_coalescingDelay.start(m_coalescingWindow);
+    }
+}
+
+void MprisPlayerPrivate::requestRate(double rate)
+{
+    if (m_coalescingWindow <= 0) {
+        Q_EMIT q_ptr->rateRequested(rate);
+        return;
+    }
+
+    m_hasPendingRate = true;
+    m_pendingRate = rate;
+
+    if (!m_coalescingDelay.isActive()) {
+        m_coalescingDelay.start(m_coalescingWindow);
+    }
+}
+
+void MprisPlayerPrivate::requestVolume(double volume)
+{
+    if (m_coalescingWindow <= 0) {
+        Q_EMIT q_ptr->volumeRequested(volume);
+        return;
+    }
+
+    m_hasPendingVolume = true;
+    m_pendingVolume = volume;
+
+    if (!m_coalescingDelay.isActive()) {
+        m_coalescingDelay.start(m_coalescingWindow);
+    }
+}
+
+void MprisPlayerPrivate::emitPendingRequests()
+{
+    m_coalescingDelay.stop();
+
+    // Cleared up front, the handlers may make new requests
+    const bool seek = m_hasPendingSeek && m_pendingSeek != 0;
+    const qlonglong offset = m_pendingSeek;
+    const bool position = m_hasPendingPosition;
+    const QString trackId = m_pendingTrackId;
+    const qlonglong absolutePosition = m_pendingPosition;
+    const bool rate = m_hasPendingRate;
+    const double requestedRate = m_pendingRate;
+    const bool volume = m_hasPendingVolume;
+    const double requestedVolume = m_pendingVolume;
+
+    m_hasPendingSeek = false;
+    m_pendingSeek = 0;
+    m_hasPendingPosition = false;
+    m_pendingTrackId.clear();
+    m_hasPendingRate = false;
+    m_hasPendingVolume = false;
+
+    if (position) {
+        Q_EMIT q_ptr->setPositionRequested(trackId, absolutePosition);
+    } else if (seek) {
+        Q_EMIT q_ptr->seekRequested(offset);
+    }
+
+    if (rate) {
+        Q_EMIT q_ptr->rateRequested(requestedRate);
+    }
+
+    if (volume) {
+        Q_EMIT q_ptr->volumeRequested(requestedVolume);
+    }
 }
 
 void MprisPlayerPrivate::emitPropertiesChanged()
@@ -327,6 +631,10 @@ void MprisPlayerPrivate::emitPropertiesChanged()
     if (!m_connection)
         return;
 
+    const qint64 now = m_changedClock.elapsed();
+    const qint64 latency = m_firstChange < 0 ? 0 : now - m_firstChange;
+    int batchSize = 0;
+
     for (auto i = m_changedProperties.cbegin();
          i != m_changedProperties.cend();
          ++i) {
@@ -339,16 +647,36 @@ void MprisPlayerPrivate::emitPropertiesChanged()
         msg << QStringList(i.value().second.values());
 
         m_connection->send(msg);
+        batchSize += i.value().first.size() + i.value().second.size();
     }
 
     m_changedProperties.clear();
+    m_firstChange = -1;
+    m_urgentChangePending = false;
+    m_lastChangedSignal = now;
+
+    ++m_changedStatistics.batches;
+    m_changedStatistics.properties += batchSize;
+    m_changedStatistics.maximumBatchSize = qMax(m_changedStatistics.maximumBatchSize, batchSize);
+    m_changedStatistics.totalLatency += latency;
+    m_changedStatistics.maximumLatency = qMax(m_changedStatistics.maximumLatency, latency);
 }
 
 MprisPlayer::MprisPlayer(QObject *parent)
     : QObject(parent)
     , priv(new MprisPlayerPrivate(this))
 {
-    connect(this, &MprisPlayer::seeked, priv, [this](qlonglong position) { Q_EMIT priv->m_playerAdaptor.Seeked(position * 1000); });
+    connect(this, &MprisPlayer::seeked, priv, [this](qlonglong position) {
+        Q_EMIT priv->m_playerAdaptor.Seeked(position * 1000);
+
+        // Adaptor signals are relayed only for registered objects
+        if (priv->m_service) {
+            QDBusMessage msg = QDBusMessage::createSignal(QStringLiteral("/org/mpris/MediaPlayer2"),
+                                                          PlayerInterface, QStringLiteral("Seeked"));
+            msg << position * 1000;
+            priv->m_connection->send(msg);
+        }
+    });
 }
 
 MprisPlayer::~MprisPlayer()
@@ -436,6 +764,10 @@ Mpris::PlaybackStatus MprisPlayer::playbackStatus() const
 
 qlonglong MprisPlayer::position() const
 {
+    if (priv->m_hasPositionSnapshot) {
+        return priv->extrapolatedPosition();
+    }
+
     // If position() is called from positionRequested handler, we would
     // end up in an infinite recursion loop. Avoid it and spew out a warning.
     if (!priv->m_inPositionRequested) {
@@ -462,12 +794,20 @@ double MprisPlayer::volume() const
     return priv->m_volume;
 }
 
+int MprisPlayer::requestCoalescingWindow() const
+{
+    return priv->m_coalescingWindow;
+}
+
 void MprisPlayer::setCanControl(bool canControl)
 {
     if (canControl != priv->m_canControl) {
         if (!priv->m_playerPropertiesAdaptor.propertiesLocked()) {
             priv->m_canControl = canControl;
+            // The Can* getters depend on it, without a change of their own
+            ++priv->m_propertiesGeneration;
             Q_EMIT canControlChanged();
+            priv->publishState();
         }
     }
 }
@@ -478,6 +818,9 @@ void MprisPlayer::setCanGoNext(bool canGoNext)
         if (canControl()) {
             Q_EMIT canGoNextChanged();
             priv->propertyChanged(PlayerInterface, QStringLiteral("CanGoNext"), canGoNext);
+        } else {
+            // Read as false meanwhile, but cached replies can't tell
+            ++priv->m_propertiesGeneration;
         }
     }
 }
@@ -488,6 +831,8 @@ void MprisPlayer::setCanGoPrevious(bool canGoPrevious)
         if (canControl()) {
             Q_EMIT canGoPreviousChanged();
             priv->propertyChanged(PlayerInterface, QStringLiteral("CanGoPrevious"), canGoPrevious);
+        } else {
+            ++priv->m_propertiesGeneration;
         }
     }
 }
@@ -498,6 +843,8 @@ void MprisPlayer::setCanPause(bool canPause)
         if (canControl()) {
             Q_EMIT canPauseChanged();
             priv->propertyChanged(PlayerInterface, QStringLiteral("CanPause"), canPause);
+        } else {
+            ++priv->m_propertiesGeneration;
         }
     }
 }
@@ -508,6 +855,8 @@ void MprisPlayer::setCanPlay(bool canPlay)
         if (canControl()) {
             Q_EMIT canPlayChanged();
             priv->propertyChanged(PlayerInterface, QStringLiteral("CanPlay"), canPlay);
+        } else {
+            ++priv->m_propertiesGeneration;
         }
     }
 }
@@ -518,6 +867,8 @@ void MprisPlayer::setCanSeek(bool canSeek)
         if (canControl()) {
             Q_EMIT canSeekChanged();
             priv->propertyChanged(PlayerInterface, QStringLiteral("CanSeek"), canSeek);
+        } else {
+            ++priv->m_propertiesGeneration;
         }
     }
 }
@@ -527,6 +878,7 @@ void MprisPlayer::setHasShuffle(bool hasShuffle)
         if (!priv->m_playerPropertiesAdaptor.propertiesLocked()) {
             priv->m_hasShuffle = hasShuffle;
             priv->m_playerPropertiesAdaptor.hideProperty(QStringLiteral("Shuffle"), !hasShuffle);
+            priv->publishState();
             if (canControl()) {
                 Q_EMIT hasShuffleChanged();
             }
@@ -539,6 +891,7 @@ void MprisPlayer::setHasLoopStatus(bool hasLoopStatus)
         if (!priv->m_playerPropertiesAdaptor.propertiesLocked()) {
             priv->m_hasLoopStatus = hasLoopStatus;
             priv->m_playerPropertiesAdaptor.hideProperty(QStringLiteral("LoopStatus"), !hasLoopStatus);
+            priv->publishState();
             if (canControl()) {
                 Q_EMIT hasLoopStatusChanged();
             }
@@ -546,6 +899,21 @@ void MprisPlayer::setHasLoopStatus(bool hasLoopStatus)
     }
 }
 
+void MprisPlayer::setRequestCoalescingWindow(int window)
+{
+    window = qMax(0, window);
+
+    if (window != priv->m_coalescingWindow) {
+        priv->m_coalescingWindow = window;
+
+        // Nothing waits for a window that is gone
+        if (!window) {
+            priv->emitPendingRequests();
+        }
+        Q_EMIT requestCoalescingWindowChanged();
+    }
+}
+
 void MprisPlayer::setLoopStatus(Mpris::LoopStatus loopStatus)
 {
     if (loopStatus != priv->m_loopStatus) {
@@ -574,6 +942,7 @@ void MprisPlayer::setMinimumRate(double minimumRate)
 void MprisPlayer::setPlaybackStatus(Mpris::PlaybackStatus playbackStatus)
 {
     if (playbackStatus != priv->m_playbackStatus) {
+        priv->rebasePositionSnapshot();
         priv->m_playbackStatus = playbackStatus;
         Q_EMIT playbackStatusChanged();
         priv->propertyChanged(PlayerInterface, QStringLiteral("PlaybackStatus"), priv->playbackStatus());
@@ -581,14 +950,42 @@ void MprisPlayer::setPlaybackStatus(Mpris::PlaybackStatus playbackStatus)
 }
 void MprisPlayer::setPosition(qlonglong position)
 {
+    if (priv->m_hasPositionSnapshot) {
+        priv->m_snapshotPosition = position;
+        priv->m_snapshotTime = monotonicNow();
+    }
+
     if (position != priv->m_position) {
         priv->m_position = position;
         Q_EMIT positionChanged();
     }
+
+    priv->publishState();
+}
+
+void MprisPlayer::setPositionSnapshot(qlonglong position, qint64 timestamp)
+{
+    priv->m_hasPositionSnapshot = true;
+    priv->m_snapshotPosition = position;
+    priv->m_snapshotTime = timestamp < 0 ? monotonicNow() : timestamp;
+
+    if (position != priv->m_position) {
+        priv->m_position = position;
+        Q_EMIT positionChanged();
+    }
+
+    priv->publishState();
+}
+
+void MprisPlayer::clearPositionSnapshot()
+{
+    priv->m_hasPositionSnapshot = false;
+    priv->publishState();
 }
 void MprisPlayer::setRate(double rate)
 {
     if (rate != priv->m_rate) {
+        priv->rebasePositionSnapshot();
         priv->m_rate = rate;
         Q_EMIT rateChanged();
         priv->propertyChanged(PlayerInterface, QStringLiteral("Rate"), rate);
@@ -669,9 +1066,12 @@ void MprisPlayer::setServiceName(const QString &serviceName)
         QDBusConnection::disconnectFromBus(priv->m_connection->name());
         delete priv->m_connection;
         priv->m_connection = nullptr;
+        if (priv->m_service) {
+            priv->m_service->deleteLater();
+            priv->m_service = nullptr;
+        }
         priv->m_playerPropertiesAdaptor.reset();
-        priv->m_changedDelay.stop();
-        priv->m_changedProperties.clear();
+        priv->cancelPropertiesChanged();
     }
 
     if (!serviceName.isEmpty()) {
@@ -683,7 +1083,15 @@ void MprisPlayer::setServiceName(const QString &serviceName)
             priv->m_serviceName = serviceName;
         }
 
-        priv->m_connection->registerObject(QStringLiteral("/org/mpris/MediaPlayer2"), priv);
+        if (s_serviceThreadEnabled) {
+            priv->m_service = new MprisPlayerService;
+            connect(priv->m_service, &MprisPlayerService::requested,
+                    priv, &MprisPlayerPrivate::onServiceRequest, Qt::QueuedConnection);
+            priv->publishState();
+            priv->m_connection->registerVirtualObject(QStringLiteral("/org/mpris/MediaPlayer2"), priv->m_service);
+        } else {
+            priv->m_connection->registerObject(QStringLiteral("/org/mpris/MediaPlayer2"), priv);
+        }
         priv->m_connection->registerService(priv->m_serviceName);
     } else {
         priv->m_serviceName = serviceName;
@@ -692,6 +1100,26 @@ void MprisPlayer::setServiceName(const QString &serviceName)
     Q_EMIT serviceNameChanged();
 }
 
+MprisPlayer::PropertiesChangedStatistics MprisPlayer::propertiesChangedStatistics() const
+{
+    return priv->m_changedStatistics;
+}
+
+MprisPlayer::GetAllCacheStatistics MprisPlayer::getAllCacheStatistics() const
+{
+    return priv->m_playerPropertiesAdaptor.statistics();
+}
+
+bool MprisPlayer::serviceThreadEnabled()
+{
+    return s_serviceThreadEnabled;
+}
+
+void MprisPlayer::setServiceThreadEnabled(bool enabled)
+{
+    s_serviceThreadEnabled = enabled;
+}
+
 void MprisPlayer::setCanQuit(bool canQuit)
 {
     if (priv->m_canQuit != canQuit) {
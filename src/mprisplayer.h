@@ -62,11 +62,39 @@ class AMBER_MPRIS_EXPORT MprisPlayer : public QObject
     Q_PROPERTY(double volume READ volume WRITE setVolume NOTIFY volumeChanged)
     Q_PROPERTY(bool hasShuffle READ hasShuffle WRITE setHasShuffle NOTIFY hasShuffleChanged)
     Q_PROPERTY(bool hasLoopStatus READ hasLoopStatus WRITE setHasLoopStatus NOTIFY hasLoopStatusChanged)
+    Q_PROPERTY(int requestCoalescingWindow READ requestCoalescingWindow WRITE setRequestCoalescingWindow NOTIFY requestCoalescingWindowChanged)
 
 public:
     MprisPlayer(QObject *parent = 0);
     virtual ~MprisPlayer();
 
+    // Answers the calls to the Mpris object from a thread of its own,
+    // so that a busy player thread doesn't stall its clients. Only the
+    // control requests are delivered to the player's thread. Applies to
+    // the players registered afterwards. Position reads can't wait for
+    // the player there, positionRequested is not emitted. They are
+    // extrapolated from setPositionSnapshot() instead, or answer the
+    // last setPosition() value when no snapshot is set.
+    static bool serviceThreadEnabled();
+    static void setServiceThreadEnabled(bool enabled);
+
+    struct PropertiesChangedStatistics {
+        quint64 batches;            // PropertiesChanged rounds sent
+        quint64 properties;         // properties carried by them
+        int maximumBatchSize;
+        qint64 totalLatency;        // ms from the first change of a batch to its signal
+        qint64 maximumLatency;
+    };
+    PropertiesChangedStatistics propertiesChangedStatistics() const;
+
+    // Replies of the service thread are built from the published state
+    // and are not counted
+    struct GetAllCacheStatistics {
+        quint64 hits;               // GetAll replies served from the cache
+        quint64 misses;             // GetAll replies read from the player
+    };
+    GetAllCacheStatistics getAllCacheStatistics() const;
+
     QString serviceName() const;
     bool canQuit() const;
     bool canRaise() const;
@@ -95,6 +123,7 @@ public:
     double rate() const;
     bool shuffle() const;
     double volume() const;
+    int requestCoalescingWindow() const;
 
     virtual void setServiceName(const QString &serviceName);
     void setCanQuit(bool canQuit);
@@ -124,6 +153,19 @@ public:
     void setHasShuffle(bool hasShuffle);
     void setHasLoopStatus(bool hasLoopStatus);
 
+    // Milliseconds for which Seek, SetPosition, Volume and Rate requests
+    // are gathered before the requested signals are emitted. Seek offsets
+    // add up, only the last SetPosition, Volume and Rate are kept. Zero,
+    // the default, emits every request right away.
+    void setRequestCoalescingWindow(int window);
+
+    // Publishes the position in milliseconds as of the given timestamp,
+    // in milliseconds of the QElapsedTimer clock, or now when negative.
+    // Position reads are then extrapolated from the snapshot with the
+    // playback status and rate, without emitting positionRequested.
+    Q_INVOKABLE void setPositionSnapshot(qlonglong position, qint64 timestamp = -1);
+    Q_INVOKABLE void clearPositionSnapshot();
+
 Q_SIGNALS:
     void serviceNameChanged();
     void canQuitChanged();
@@ -157,6 +199,7 @@ Q_SIGNALS:
     void volumeChanged();
     void hasShuffleChanged();
     void hasLoopStatusChanged();
+    void requestCoalescingWindowChanged();
 
     void positionRequested();
     void loopStatusRequested(int loopStatus);
@@ -23,11 +23,13 @@
 #include <QObject>
 #include <QVariantMap>
 #include <QDBusContext>
+#include <QElapsedTimer>
 #include "mprismetadata.h"
 #include "mprisplayeradaptor_p.h"
 #include "mprisserviceadaptor_p.h"
 #include "mprispropertiesadaptor_p.h"
 #include "mprisintrospectableadaptor_p.h"
+#include "mprisplayerservice_p.h"
 #include "mprisplayer.h"
 
 namespace Amber {
@@ -44,6 +46,7 @@ public:
 
     MprisPlayer *q_ptr;
     QDBusConnection *m_connection;
+    MprisPlayerService *m_service;      // when served from the service thread
     MprisServiceAdaptor m_serviceAdaptor;
     MprisPlayerAdaptor m_playerAdaptor;
     MprisPropertiesAdaptor m_playerPropertiesAdaptor;
@@ -61,6 +64,13 @@ public:
     QStringList m_supportedMimeTypes;
     QMap<QString, QPair<QVariantMap, QSet<QString>>> m_changedProperties;
     QTimer m_changedDelay;
+    QElapsedTimer m_changedClock;
+    qint64 m_firstChange;           // of the pending batch, -1 when none
+    qint64 m_changedDue;
+    qint64 m_lastChangedSignal;
+    bool m_urgentChangePending;
+
+    MprisPlayer::PropertiesChangedStatistics m_changedStatistics;
 
     MprisMetaData m_metaData;
     bool m_canControl;
@@ -80,6 +90,23 @@ public:
     bool m_shuffle;
     double m_volume;
     bool m_inPositionRequested;
+    bool m_hasPositionSnapshot;
+    qlonglong m_snapshotPosition;       // ms
+    qint64 m_snapshotTime;              // ms of the QElapsedTimer clock
+    quint64 m_propertiesGeneration;     // bumped on every property change
+
+    // Requests gathered for the coalescing window
+    int m_coalescingWindow;             // ms, zero when not coalescing
+    QTimer m_coalescingDelay;
+    bool m_hasPendingSeek;
+    qlonglong m_pendingSeek;            // ms, relative
+    bool m_hasPendingPosition;
+    QString m_pendingTrackId;
+    qlonglong m_pendingPosition;        // ms
+    bool m_hasPendingRate;
+    double m_pendingRate;
+    bool m_hasPendingVolume;
+    double m_pendingVolume;
 
 public Q_SLOTS:
     // Player Adaptor
@@ -118,9 +145,21 @@ public:
     void Stop();
 
     void propertyChanged(const QString &iface, const QString &name, const QVariant &value);
+    void cancelPropertiesChanged();
+    void publishState();
+
+    void requestSeek(qlonglong offset);
+    void requestPosition(const QString &trackId, qlonglong position);
+    void requestRate(double rate);
+    void requestVolume(double volume);
+    void emitPendingRequests();
+
+    qlonglong extrapolatedPosition() const;
+    void rebasePositionSnapshot();
 
 private Q_SLOTS:
     void emitPropertiesChanged();
+    void onServiceRequest(int request, const QVariant &argument, const QVariant &secondArgument);
 };
 }
 
@@ -17,6 +17,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <QDBusArgument>
 #include <QLoggingCategory>
 #include "mprisclient_p.h"
 #include "mpris.h"
@@ -51,52 +52,74 @@ MprisPlayerInterface::MprisPlayerInterface(const QString &service, const QString
     , m_shuffle(false)
     , m_volume(0)
 {
-    connect(this, SIGNAL(propertyChanged(QString, QVariant)), this, SLOT(onPropertyChanged(QString, QVariant)));
+    Q_ASSERT(!qstrcmp(staticMetaObject.property(staticMetaObject.propertyOffset() + VolumeProperty).name(),
+                      "Volume"));
+
+    // Every client has a root and a player interface on the same path,
+    // share one PropertiesChanged match rule among all of them.
+    setSharedPropertiesChanged(true);
+
+    // Changes are delivered through updateProperty(), connecting to the
+    // invalidation keeps the PropertiesChanged subscription in place.
+    connect(this, SIGNAL(propertyInvalidated(QString)), this, SLOT(onPropertyInvalidated(QString)));
 }
 
 MprisPlayerInterface::~MprisPlayerInterface()
 {
 }
 
-void MprisPlayerInterface::onPropertyChanged(const QString &propertyName, const QVariant &value)
+bool MprisPlayerInterface::updateProperty(int propertyIndex, const QVariant &value)
 {
-    if (propertyName == QStringLiteral("CanControl")) {
+    switch (propertyIndex - staticMetaObject.propertyOffset()) {
+    case CanControlProperty: {
         bool canControl = value.toBool();
         if (m_canControl != canControl) {
             m_canControl = canControl;
             Q_EMIT canControlChanged(m_canControl);
         }
-    } else if (propertyName == QStringLiteral("CanGoNext")) {
+        return true;
+    }
+    case CanGoNextProperty: {
         bool canGoNext = value.toBool();
         if (m_canGoNext != canGoNext) {
             m_canGoNext = canGoNext;
             Q_EMIT canGoNextChanged(m_canGoNext);
         }
-    } else if (propertyName == QStringLiteral("CanGoPrevious")) {
+        return true;
+    }
+    case CanGoPreviousProperty: {
         bool canGoPrevious = value.toBool();
         if (m_canGoPrevious != canGoPrevious) {
             m_canGoPrevious = canGoPrevious;
             Q_EMIT canGoPreviousChanged(m_canGoPrevious);
         }
-    } else if (propertyName == QStringLiteral("CanPause")) {
+        return true;
+    }
+    case CanPauseProperty: {
         bool canPause = value.toBool();
         if (m_canPause != canPause) {
             m_canPause = canPause;
             Q_EMIT canPauseChanged(m_canPause);
         }
-    } else if (propertyName == QStringLiteral("CanPlay")) {
+        return true;
+    }
+    case CanPlayProperty: {
         bool canPlay = value.toBool();
         if (m_canPlay != canPlay) {
             m_canPlay = canPlay;
             Q_EMIT canPlayChanged(m_canPlay);
         }
-    } else if (propertyName == QStringLiteral("CanSeek")) {
+        return true;
+    }
+    case CanSeekProperty: {
         bool canSeek = value.toBool();
         if (m_canSeek != canSeek) {
             m_canSeek = canSeek;
             Q_EMIT canSeekChanged(m_canSeek);
         }
-    } else if (propertyName == QStringLiteral("LoopStatus")) {
+        return true;
+    }
+    case LoopStatusProperty: {
         if (!m_hasLoopStatus) {
             m_hasLoopStatus = true;
             Q_EMIT hasLoopStatusChanged(true);
@@ -106,43 +129,57 @@ void MprisPlayerInterface::onPropertyChanged(const QString &propertyName, const
             m_loopStatus = loopStatus;
             Q_EMIT loopStatusChanged(MprisPrivate::loopStatusToString(m_loopStatus));
         }
-    } else if (propertyName == QStringLiteral("MaximumRate")) {
-        bool maximumRate = value.toDouble();
+        return true;
+    }
+    case MaximumRateProperty: {
+        double maximumRate = value.toDouble();
         if (m_maximumRate != maximumRate) {
             m_maximumRate = maximumRate;
             Q_EMIT maximumRateChanged(m_maximumRate);
         }
-    } else if (propertyName == QStringLiteral("Metadata")) {
-        QVariantMap metadata = value.toMap();
+        return true;
+    }
+    case MetadataProperty: {
+        QVariantMap metadata = qdbus_cast<QVariantMap>(value);
         if (m_metadata != metadata) {
             m_metadata = metadata;
             Q_EMIT metadataChanged(m_metadata);
         }
-    } else if (propertyName == QStringLiteral("MinimumRate")) {
+        return true;
+    }
+    case MinimumRateProperty: {
         double minimumRate = value.toDouble();
         if (m_minimumRate != minimumRate) {
             m_minimumRate = minimumRate;
             Q_EMIT minimumRateChanged(m_minimumRate);
         }
-    } else if (propertyName == QStringLiteral("PlaybackStatus")) {
+        return true;
+    }
+    case PlaybackStatusProperty: {
         Mpris::PlaybackStatus playbackStatus = MprisPrivate::stringToPlaybackStatus(value.toString());
         if (m_playbackStatus != playbackStatus) {
             m_playbackStatus = playbackStatus;
             Q_EMIT playbackStatusChanged(MprisPrivate::playbackToString(m_playbackStatus));
         }
-    } else if (propertyName == QStringLiteral("Position")) {
+        return true;
+    }
+    case PositionProperty: {
         qlonglong position = value.toLongLong();
         if (m_position != position) {
             m_position = position;
             Q_EMIT positionChanged(m_position);
         }
-    } else if (propertyName == QStringLiteral("Rate")) {
+        return true;
+    }
+    case RateProperty: {
         double rate = value.toDouble();
         if (m_rate != rate) {
             m_rate = rate;
             Q_EMIT rateChanged(m_rate);
         }
-    } else if (propertyName == QStringLiteral("Shuffle")) {
+        return true;
+    }
+    case ShuffleProperty: {
         if (!m_hasShuffle) {
             m_hasShuffle = true;
             Q_EMIT hasShuffleChanged(true);
@@ -152,16 +189,25 @@ void MprisPlayerInterface::onPropertyChanged(const QString &propertyName, const
             m_shuffle = shuffle;
             Q_EMIT shuffleChanged(m_shuffle);
         }
-    } else if (propertyName == QStringLiteral("Volume")) {
+        return true;
+    }
+    case VolumeProperty: {
         double volume = value.toDouble();
         if (m_volume != volume) {
             m_volume = volume;
             Q_EMIT volumeChanged(m_volume);
         }
-    } else {
+        return true;
+    }
+    default:
         qCWarning(lcPlayerIface) << Q_FUNC_INFO
                                  << "Received PropertyChanged signal from unknown property: "
-                                 << propertyName;
+                                 << staticMetaObject.property(propertyIndex).name();
+        return false;
     }
 }
 
+void MprisPlayerInterface::onPropertyInvalidated(const QString &propertyName)
+{
+    qCDebug(lcPlayerIface) << Q_FUNC_INFO << "Property" << propertyName << "invalidated";
+}
@@ -0,0 +1,364 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+
+#include "mprisplayerservice_p.h"
+
+#include "mpris_p.h"
+
+#include <QDBusObjectPath>
+#include <QDBusVariant>
+#include <QElapsedTimer>
+#include <QThread>
+
+using namespace Amber;
+
+namespace {
+    const QString PropertiesInterface = QStringLiteral("org.freedesktop.DBus.Properties");
+    const QString PlayerInterface = QStringLiteral("org.mpris.MediaPlayer2.Player");
+    const QString ServiceInterface = QStringLiteral("org.mpris.MediaPlayer2");
+    const QString PositionProperty = QStringLiteral("Position");
+
+    // Started on first use, shared by the services of every player
+    class ServiceThread : public QThread
+    {
+    public:
+        ServiceThread()
+        {
+            setObjectName(QStringLiteral("org.amber.mpris.service"));
+            start();
+        }
+
+        ~ServiceThread()
+        {
+            quit();
+            wait();
+        }
+    };
+
+    Q_GLOBAL_STATIC(ServiceThread, serviceThread)
+
+    qint64 monotonicNow()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        return timer.msecsSinceReference();
+    }
+
+    void sendReply(const QDBusConnection &connection, const QDBusMessage &message, const QVariant &value = QVariant())
+    {
+        connection.send(value.isValid() ? message.createReply(value) : message.createReply());
+    }
+
+    void sendError(const QDBusConnection &connection, const QDBusMessage &message, QDBusError::ErrorType type, const QString &text)
+    {
+        connection.send(message.createErrorReply(type, text));
+    }
+
+    void sendPropertyNotFound(const QDBusConnection &connection, const QDBusMessage &message,
+                              const QString &interface_name, const QString &property_name)
+    {
+        sendError(connection, message, QDBusError::UnknownProperty,
+                  QString::fromLatin1("Property %1%2%3 was not found in object %4")
+                  .arg(interface_name,
+                       QString::fromLatin1(interface_name.isEmpty() ? "" : "."),
+                       property_name, message.path()));
+    }
+}
+
+MprisPlayerState::MprisPlayerState()
+    : propertiesLocked(false)
+    , canControl(false)
+    , canGoNext(false)
+    , canGoPrevious(false)
+    , canPause(false)
+    , canPlay(false)
+    , canSeek(false)
+    , minimumRate(1)
+    , maximumRate(1)
+    , hasPositionSnapshot(false)
+    , position(0)
+    , positionTime(0)
+    , playing(false)
+    , rate(1.0)
+    , duration(0)
+{
+}
+
+qlonglong MprisPlayerState::currentPosition() const
+{
+    // Without a snapshot the player can't be asked from here
+    if (!hasPositionSnapshot) {
+        return position;
+    }
+    return extrapolate(position, positionTime, playing, rate, duration);
+}
+
+qlonglong MprisPlayerState::extrapolate(qlonglong position, qint64 time, bool playing, double rate, qlonglong duration)
+{
+    if (playing) {
+        position += qlonglong((monotonicNow() - time) * rate);
+
+        if (duration > 0) {
+            position = qMin(position, duration);
+        }
+    }
+
+    return qMax<qlonglong>(0, position);
+}
+
+MprisPlayerService::MprisPlayerService()
+    : QDBusVirtualObject(nullptr)
+{
+    moveToThread(serviceThread());
+}
+
+MprisPlayerService::~MprisPlayerService()
+{
+}
+
+std::shared_ptr<const MprisPlayerState> MprisPlayerService::state() const
+{
+    return std::atomic_load(&m_state);
+}
+
+void MprisPlayerService::publish(const std::shared_ptr<const MprisPlayerState> &state)
+{
+    std::atomic_store(&m_state, state);
+}
+
+QString MprisPlayerService::introspect(const QString &path) const
+{
+    Q_UNUSED(path)
+
+    const std::shared_ptr<const MprisPlayerState> state = this->state();
+    if (!state) {
+        return QString();
+    }
+
+    if (!state->propertiesLocked) {
+        Q_EMIT const_cast<MprisPlayerService *>(this)->requested(LockProperties, QVariant(), QVariant());
+    }
+
+    return state->interfaceXml;
+}
+
+bool MprisPlayerService::handleMessage(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    const std::shared_ptr<const MprisPlayerState> state = this->state();
+    if (!state || message.type() != QDBusMessage::MethodCallMessage) {
+        return false;
+    }
+
+    const QString interface = message.interface();
+    if (interface == PropertiesInterface) {
+        return handleProperties(*state, message, connection);
+    } else if (interface == PlayerInterface) {
+        return handlePlayer(*state, message, connection);
+    } else if (interface == ServiceInterface) {
+        return handleService(message, connection);
+    } else if (interface.isEmpty()) {
+        // The member names don't overlap between the interfaces
+        return handleProperties(*state, message, connection)
+                || handlePlayer(*state, message, connection)
+                || handleService(message, connection);
+    }
+
+    // Introspectable and Peer
+    return false;
+}
+
+bool MprisPlayerService::handleProperties(const MprisPlayerState &state, const QDBusMessage &message, const QDBusConnection &connection)
+{
+    const QString member = message.member();
+    const QString signature = message.signature();
+    const QList<QVariant> arguments = message.arguments();
+
+    if (member == QLatin1String("Get") && signature == QLatin1String("ss")) {
+        const QString interface_name = arguments.at(0).toString();
+        const QString property_name = arguments.at(1).toString();
+
+        QVariant value;
+        if (interface_name == PlayerInterface) {
+            value = property_name == PositionProperty
+                    ? QVariant(state.currentPosition() * 1000)
+                    : state.playerProperties.value(property_name);
+        } else if (interface_name == ServiceInterface) {
+            value = state.serviceProperties.value(property_name);
+        }
+
+        if (value.isValid()) {
+            sendReply(connection, message, QVariant::fromValue(QDBusVariant(value)));
+        } else {
+            sendPropertyNotFound(connection, message, interface_name, property_name);
+        }
+    } else if (member == QLatin1String("GetAll") && signature == QLatin1String("s")) {
+        const QString interface_name = arguments.at(0).toString();
+
+        if (!state.propertiesLocked) {
+            Q_EMIT requested(LockProperties, QVariant(), QVariant());
+        }
+
+        if (interface_name == PlayerInterface) {
+            QVariantMap properties = state.playerProperties;
+            properties.insert(PositionProperty, state.currentPosition() * 1000);
+            sendReply(connection, message, properties);
+        } else if (interface_name == ServiceInterface) {
+            sendReply(connection, message, state.serviceProperties);
+        } else {
+            sendPropertyNotFound(connection, message, interface_name, QString());
+        }
+    } else if (member == QLatin1String("Set") && signature == QLatin1String("ssv")) {
+        const QString interface_name = arguments.at(0).toString();
+        const QString property_name = arguments.at(1).toString();
+        const QVariant value = qvariant_cast<QDBusVariant>(arguments.at(2)).variant();
+
+        int request = -1;
+        int type = QMetaType::UnknownType;
+        bool exists = false;
+
+        if (interface_name == PlayerInterface) {
+            exists = property_name == PositionProperty || state.playerProperties.contains(property_name);
+            if (property_name == QLatin1String("LoopStatus")) {
+                request = SetLoopStatus;
+                type = QMetaType::QString;
+            } else if (property_name == QLatin1String("Rate")) {
+                request = SetRate;
+                type = QMetaType::Double;
+            } else if (property_name == QLatin1String("Shuffle")) {
+                request = SetShuffle;
+                type = QMetaType::Bool;
+            } else if (property_name == QLatin1String("Volume")) {
+                request = SetVolume;
+                type = QMetaType::Double;
+            }
+        } else if (interface_name == ServiceInterface) {
+            exists = state.serviceProperties.contains(property_name);
+            if (property_name == QLatin1String("Fullscreen")) {
+                request = SetFullscreen;
+                type = QMetaType::Bool;
+            }
+        }
+
+        bool ok = true;
+
+        if (!exists) {
+            sendPropertyNotFound(connection, message, interface_name, property_name);
+        } else if (request < 0) {
+            sendError(connection, message, QDBusError::PropertyReadOnly,
+                      QString::fromLatin1("Property %1.%2 is read-only").arg(interface_name, property_name));
+        } else if (value.userType() != type) {
+            sendError(connection, message, QDBusError::InternalError, QString::fromLatin1("Internal error"));
+        } else if (request == SetLoopStatus) {
+            const Mpris::LoopStatus loopStatus = MprisPrivate::stringToLoopStatus(value.toString(), &ok);
+            if (ok) {
+                Q_EMIT requested(request, static_cast<int>(loopStatus), QVariant());
+                sendReply(connection, message);
+            } else {
+                sendError(connection, message, QDBusError::InvalidArgs, QStringLiteral("Invalid loop status"));
+            }
+        } else if (request != SetFullscreen && !state.canControl) {
+            sendError(connection, message, QDBusError::NotSupported, QStringLiteral("The operation is not supported"));
+        } else if (request == SetRate && (value.toDouble() < state.minimumRate || value.toDouble() > state.maximumRate)) {
+            sendError(connection, message, QDBusError::InvalidArgs, QStringLiteral("Rate not in the allowed range"));
+        } else {
+            Q_EMIT requested(request, value, QVariant());
+            sendReply(connection, message);
+        }
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool MprisPlayerService::handlePlayer(const MprisPlayerState &state, const QDBusMessage &message, const QDBusConnection &connection)
+{
+    const QString member = message.member();
+    const QString signature = message.signature();
+    const QList<QVariant> arguments = message.arguments();
+
+    Request request;
+    bool allowed = true;
+    QVariant argument;
+    QVariant secondArgument;
+
+    if (member == QLatin1String("Next") && signature.isEmpty()) {
+        request = Next;
+        allowed = state.canGoNext;
+    } else if (member == QLatin1String("OpenUri") && signature == QLatin1String("s")) {
+        request = OpenUri;
+        argument = arguments.at(0);
+    } else if (member == QLatin1String("Pause") && signature.isEmpty()) {
+        request = Pause;
+        allowed = state.canPause;
+    } else if (member == QLatin1String("Play") && signature.isEmpty()) {
+        request = Play;
+        allowed = state.canPlay;
+    } else if (member == QLatin1String("PlayPause") && signature.isEmpty()) {
+        request = PlayPause;
+        allowed = state.canPlay || state.canPause;
+    } else if (member == QLatin1String("Previous") && signature.isEmpty()) {
+        request = Previous;
+        allowed = state.canGoPrevious;
+    } else if (member == QLatin1String("Seek") && signature == QLatin1String("x")) {
+        request = Seek;
+        allowed = state.canSeek;
+        argument = arguments.at(0);
+    } else if (member == QLatin1String("SetPosition") && signature == QLatin1String("ox")) {
+        request = SetPosition;
+        allowed = state.canSeek;
+        argument = qvariant_cast<QDBusObjectPath>(arguments.at(0)).path();
+        secondArgument = arguments.at(1);
+    } else if (member == QLatin1String("Stop") && signature.isEmpty()) {
+        request = Stop;
+    } else {
+        return false;
+    }
+
+    if (!state.canControl) {
+        sendError(connection, message, QDBusError::NotSupported, QStringLiteral("The operation is not supported"));
+    } else if (!allowed) {
+        sendError(connection, message, QDBusError::Failed, QStringLiteral("The operation can not be performed"));
+    } else {
+        Q_EMIT requested(request, argument, secondArgument);
+        sendReply(connection, message);
+    }
+
+    return true;
+}
+
+bool MprisPlayerService::handleService(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    const QString member = message.member();
+
+    if (!message.signature().isEmpty()) {
+        return false;
+    } else if (member == QLatin1String("Quit")) {
+        Q_EMIT requested(Quit, QVariant(), QVariant());
+    } else if (member == QLatin1String("Raise")) {
+        Q_EMIT requested(Raise, QVariant(), QVariant());
+    } else {
+        return false;
+    }
+
+    sendReply(connection, message);
+    return true;
+}
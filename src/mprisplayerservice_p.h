@@ -0,0 +1,144 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the public API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+//
+
+
+#ifndef MPRISPLAYERSERVICE_P_H
+#define MPRISPLAYERSERVICE_P_H
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusVirtualObject>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+
+#include <memory>
+
+namespace Amber {
+
+/*
+ * Everything needed to answer the Mpris object's incoming calls
+ * without touching the player. Built on the player's thread and never
+ * changed after being published.
+ */
+struct MprisPlayerState
+{
+    MprisPlayerState();
+
+    QVariantMap playerProperties;       // without Position and the masked ones
+    QVariantMap serviceProperties;
+    QSet<QString> maskedProperties;
+    QString interfaceXml;
+    bool propertiesLocked;
+
+    bool canControl;
+    bool canGoNext;
+    bool canGoPrevious;
+    bool canPause;
+    bool canPlay;
+    bool canSeek;
+    double minimumRate;
+    double maximumRate;
+
+    bool hasPositionSnapshot;
+    qlonglong position;                 // ms
+    qint64 positionTime;                // ms of the QElapsedTimer clock
+    bool playing;
+    double rate;
+    qlonglong duration;                 // ms, zero when unknown
+
+    qlonglong currentPosition() const;
+
+    static qlonglong extrapolate(qlonglong position, qint64 time, bool playing, double rate, qlonglong duration);
+};
+
+/*
+ * Serves the Mpris object of one player from the process wide service
+ * thread.
+ *
+ * Reads are answered from the last published MprisPlayerState, which is
+ * swapped atomically, so a busy player thread doesn't delay them. Control
+ * requests are validated against the same state and handed over to the
+ * player's thread through requested().
+ *
+ * The standard Introspectable and Peer interfaces are left to QtDBus.
+ */
+class MprisPlayerService : public QDBusVirtualObject
+{
+    Q_OBJECT
+
+public:
+    enum Request {
+        Quit,
+        Raise,
+        SetFullscreen,
+        Next,
+        OpenUri,
+        Pause,
+        Play,
+        PlayPause,
+        Previous,
+        Seek,
+        SetPosition,
+        Stop,
+        SetLoopStatus,
+        SetRate,
+        SetShuffle,
+        SetVolume,
+        LockProperties
+    };
+
+    MprisPlayerService();
+    ~MprisPlayerService();
+
+    // Thread safe
+    std::shared_ptr<const MprisPlayerState> state() const;
+    void publish(const std::shared_ptr<const MprisPlayerState> &state);
+
+    QString introspect(const QString &path) const;
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection);
+
+Q_SIGNALS:
+    void requested(int request, const QVariant &argument, const QVariant &secondArgument);
+
+private:
+    bool handleProperties(const MprisPlayerState &state, const QDBusMessage &message, const QDBusConnection &connection);
+    bool handlePlayer(const MprisPlayerState &state, const QDBusMessage &message, const QDBusConnection &connection);
+    bool handleService(const QDBusMessage &message, const QDBusConnection &connection);
+
+    std::shared_ptr<const MprisPlayerState> m_state;
+};
+
+}
+
+#endif
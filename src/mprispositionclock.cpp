@@ -0,0 +1,136 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "mprispositionclock_p.h"
+
+#include <QThreadStorage>
+
+using namespace Amber;
+
+namespace {
+    QThreadStorage<MprisPositionClock *> s_clocks;
+}
+
+MprisPositionClock::MprisPositionClock()
+    : QObject(nullptr)
+    , m_timer(this)
+{
+    m_timer.setSingleShot(true);
+    // A coarse timer may fire early, and a label ticked before its
+    // boundary would stay behind for a whole interval
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &MprisPositionClock::onTimeout);
+    m_clock.start();
+}
+
+MprisPositionClock *MprisPositionClock::instance()
+{
+    // Timers are bound to threads, so is the clock
+    if (!s_clocks.hasLocalData()) {
+        s_clocks.setLocalData(new MprisPositionClock);
+    }
+
+    return s_clocks.localData();
+}
+
+void MprisPositionClock::subscribe(MprisPositionClockClient *client)
+{
+    for (const Subscription &subscription : qAsConst(m_subscriptions)) {
+        if (subscription.client == client) {
+            return;
+        }
+    }
+
+    Subscription subscription;
+    subscription.client = client;
+    subscription.due = m_clock.elapsed() + client->positionTickDelay();
+    m_subscriptions.append(subscription);
+
+    schedule();
+}
+
+void MprisPositionClock::unsubscribe(MprisPositionClockClient *client)
+{
+    for (int i = 0; i < m_subscriptions.size(); ++i) {
+        if (m_subscriptions.at(i).client == client) {
+            m_subscriptions.remove(i);
+            schedule();
+            return;
+        }
+    }
+}
+
+void MprisPositionClock::reschedule(MprisPositionClockClient *client)
+{
+    for (Subscription &subscription : m_subscriptions) {
+        if (subscription.client == client) {
+            subscription.due = m_clock.elapsed() + client->positionTickDelay();
+            schedule();
+            return;
+        }
+    }
+}
+
+void MprisPositionClock::onTimeout()
+{
+    const qint64 now = m_clock.elapsed();
+
+    // Every client whose boundary has passed by now shares the wakeup,
+    // none is ticked ahead of its own. Ticking may subscribe or
+    // unsubscribe clients.
+    QVector<MprisPositionClockClient *> dueClients;
+    for (Subscription &subscription : m_subscriptions) {
+        if (subscription.due <= now) {
+            dueClients.append(subscription.client);
+            subscription.due = now + subscription.client->positionTickDelay();
+        }
+    }
+
+    for (MprisPositionClockClient *client : qAsConst(dueClients)) {
+        bool subscribed = false;
+        for (const Subscription &subscription : qAsConst(m_subscriptions)) {
+            if (subscription.client == client) {
+                subscribed = true;
+                break;
+            }
+        }
+
+        if (subscribed) {
+            client->positionTick();
+        }
+    }
+
+    schedule();
+}
+
+void MprisPositionClock::schedule()
+{
+    if (m_subscriptions.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+
+    qint64 earliest = m_subscriptions.first().due;
+    for (const Subscription &subscription : qAsConst(m_subscriptions)) {
+        earliest = qMin(earliest, subscription.due);
+    }
+
+    m_timer.start(int(qMax<qint64>(earliest - m_clock.elapsed(), 0)));
+}
@@ -0,0 +1,95 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the public API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+//
+
+
+#ifndef MPRISPOSITIONCLOCK_P_H
+#define MPRISPOSITIONCLOCK_P_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+namespace Amber {
+
+class MprisPositionClockClient
+{
+public:
+    virtual ~MprisPositionClockClient() {}
+
+    // Local time in ms until the next position notification is due
+    virtual qint64 positionTickDelay() const = 0;
+    virtual void positionTick() = 0;
+};
+
+/*
+ * Drives the position notifications of all the clients of a thread
+ * from a single timer.
+ *
+ * Every client tells when its next notification is due, typically when
+ * its media position crosses the next interval boundary. The timer is
+ * armed for the earliest of them and serves every client that is due by
+ * the time it fires. It is stopped while nobody is subscribed.
+ */
+class MprisPositionClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MprisPositionClock *instance();
+
+    void subscribe(MprisPositionClockClient *client);
+    void unsubscribe(MprisPositionClockClient *client);
+    // The client's next notification moved, e.g. after a seek
+    void reschedule(MprisPositionClockClient *client);
+
+private Q_SLOTS:
+    void onTimeout();
+
+private:
+    MprisPositionClock();
+
+    void schedule();
+
+    struct Subscription {
+        MprisPositionClockClient *client;
+        qint64 due;
+    };
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QVector<Subscription> m_subscriptions;
+};
+
+}
+
+#endif
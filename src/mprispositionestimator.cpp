@@ -0,0 +1,161 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "mprispositionestimator_p.h"
+
+using namespace Amber;
+
+namespace {
+    // Resynchronization interval bounds and initial value, in ms
+    const int minimumResyncInterval = 1000;
+    const int maximumResyncInterval = 60000;
+    const int initialResyncInterval = 5000;
+
+    // Predictions closer than this are good, farther ones bad, in us
+    const qint64 goodError = 20000;
+    const qint64 badError = 100000;
+
+    // Shorter spans don't tell the skew apart from the call latency, in us
+    const qint64 minimumSkewSpan = 2000000;
+    const double maximumSkew = 0.05;
+
+    // Moving average weights of new samples
+    const double skewWeight = 0.25;
+    const double errorWeight = 0.25;
+}
+
+MprisPositionEstimator::MprisPositionEstimator()
+    : m_anchor(0)
+    , m_hasAnchor(false)
+    , m_playing(false)
+    , m_continuous(false)
+    , m_anchorMeasured(false)
+    , m_rate(1)
+    , m_skew(1)
+    , m_resyncInterval(initialResyncInterval)
+    , m_statistics()
+{
+    m_statistics.skew = m_skew;
+    m_statistics.resyncInterval = m_resyncInterval;
+    m_elapsed.start();
+}
+
+qint64 MprisPositionEstimator::position() const
+{
+    if (!m_hasAnchor || !m_playing) {
+        return m_anchor;
+    }
+
+    return m_anchor + qint64(elapsedUs() * m_rate * m_skew);
+}
+
+void MprisPositionEstimator::sample(qint64 position)
+{
+    ++m_statistics.samples;
+
+    if (m_hasAnchor && m_playing && m_continuous && m_anchorMeasured) {
+        const qint64 span = elapsedUs();
+        const qint64 error = position - this->position();
+        const qint64 absoluteError = qAbs(error);
+
+        ++m_statistics.resyncs;
+        m_statistics.lastError = error;
+        m_statistics.maximumError = qMax(m_statistics.maximumError, absoluteError);
+        m_statistics.averageError += errorWeight * (absoluteError - m_statistics.averageError);
+
+        if (span * m_rate >= minimumSkewSpan) {
+            const double skew = (position - m_anchor) / (span * m_rate);
+            // Way off means the player did something else than playing
+            if (qAbs(skew - 1) <= maximumSkew) {
+                m_skew += skewWeight * (skew - m_skew);
+            }
+        }
+
+        if (absoluteError <= goodError) {
+            m_resyncInterval = qMin(m_resyncInterval * 2, maximumResyncInterval);
+        } else if (absoluteError >= badError) {
+            m_resyncInterval = qMax(m_resyncInterval / 2, minimumResyncInterval);
+        }
+
+        m_statistics.skew = m_skew;
+        m_statistics.resyncInterval = m_resyncInterval;
+    }
+
+    rebase(position, true);
+}
+
+void MprisPositionEstimator::reset(qint64 position)
+{
+    rebase(position, true);
+}
+
+void MprisPositionEstimator::setPlaying(bool playing)
+{
+    if (m_playing == playing) {
+        return;
+    }
+
+    // Exact while paused, estimated while playing
+    const qint64 current = position();
+    const bool measured = m_anchorMeasured && !m_playing;
+    m_playing = playing;
+    rebase(current, measured);
+}
+
+void MprisPositionEstimator::setRate(double rate)
+{
+    if (qFuzzyCompare(m_rate, rate)) {
+        return;
+    }
+
+    const qint64 current = position();
+    const bool measured = m_anchorMeasured && !m_playing;
+    m_rate = rate;
+    rebase(current, measured);
+}
+
+bool MprisPositionEstimator::resyncNeeded() const
+{
+    return m_playing && m_elapsed.elapsed() > m_resyncInterval;
+}
+
+int MprisPositionEstimator::resyncInterval() const
+{
+    return m_resyncInterval;
+}
+
+MprisPositionEstimator::Statistics MprisPositionEstimator::statistics() const
+{
+    return m_statistics;
+}
+
+void MprisPositionEstimator::rebase(qint64 position, bool measured)
+{
+    m_anchor = position;
+    m_hasAnchor = true;
+    m_anchorMeasured = measured;
+    m_continuous = m_playing;
+    m_elapsed.start();
+}
+
+qint64 MprisPositionEstimator::elapsedUs() const
+{
+    return m_elapsed.nsecsElapsed() / 1000;
+}
@@ -0,0 +1,105 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the public API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+//
+
+
+#ifndef MPRISPOSITIONESTIMATOR_P_H
+#define MPRISPOSITIONESTIMATOR_P_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+namespace Amber {
+
+/*
+ * Extrapolates the playback position of a remote player between the
+ * Position samples read from it, in microseconds.
+ *
+ * The ratio between the progress reported by the player and the one
+ * expected from the local clock is tracked as a moving average, so a
+ * player whose clock runs slightly off doesn't drift. The interval of
+ * resynchronization grows while the predictions hit the samples and
+ * shrinks when they miss.
+ */
+class MprisPositionEstimator
+{
+public:
+    struct Statistics {
+        quint64 samples;        // Position samples taken
+        quint64 resyncs;        // samples compared against a prediction
+        qint64 lastError;       // prediction error of the last sample, in us
+        qint64 maximumError;    // largest absolute prediction error, in us
+        double averageError;    // moving average of the absolute error, in us
+        double skew;            // estimated player clock rate versus local
+        int resyncInterval;     // current resynchronization interval, in ms
+    };
+
+    MprisPositionEstimator();
+
+    qint64 position() const;
+
+    // A position read from the player while playback went on normally
+    void sample(qint64 position);
+    // A discontinuity, a seek or a track change
+    void reset(qint64 position);
+
+    void setPlaying(bool playing);
+    void setRate(double rate);
+
+    // Whether a fresh sample is due
+    bool resyncNeeded() const;
+    int resyncInterval() const;
+
+    Statistics statistics() const;
+
+private:
+    void rebase(qint64 position, bool measured);
+    qint64 elapsedUs() const;
+
+    qint64 m_anchor;
+    QElapsedTimer m_elapsed;
+    bool m_hasAnchor;
+    bool m_playing;
+    // Whether playback went uninterrupted at a constant rate since the
+    // anchor, only then a sample tells anything about the player clock
+    bool m_continuous;
+    // Whether the anchor was read from the player rather than estimated,
+    // predictions from an estimated anchor aren't scored
+    bool m_anchorMeasured;
+    double m_rate;
+    double m_skew;
+    int m_resyncInterval;
+    Statistics m_statistics;
+};
+
+}
+
+#endif
@@ -30,6 +30,8 @@ MprisPropertiesAdaptor::MprisPropertiesAdaptor(MprisPlayerPrivate *parent)
     : QDBusAbstractAdaptor(parent)
     , m_playerPrivate(parent)
     , m_propertiesLocked(false)
+    , m_maskGeneration(0)
+    , m_statistics()
 {
     setAutoRelaySignals(true);
 }
@@ -63,195 +65,211 @@ void MprisPropertiesAdaptor::replyInternalError()
                                     QString::fromLatin1("Internal error"));
 }
 
-// Format: {DBus property name, MprisPlayer property name or MprisPlayerPrivate getter() method}
-static const QMap<QString, QString> playerGetMap
-{
-    {"CanControl", "canControl"},
-    {"CanGoNext", "canGoNext"},
-    {"CanGoPrevious", "canGoPrevious"},
-    {"CanPause", "canPause"},
-    {"CanPlay", "canPlay"},
-    {"CanSeek", "canSeek"},
-    {"LoopStatus", "loopStatus()"},
-    {"MaximumRate", "maximumRate"},
-    {"Metadata", "metaData()"},
-    {"MinimumRate", "minimumRate"},
-    {"PlaybackStatus", "playbackStatus()"},
-    {"Position", "position()"},
-    {"Rate", "rate"},
-    {"Shuffle", "shuffle"},
-    {"Volume", "volume"},
-};
-
-static const QMap<QString, QString> serviceGetMap
-{
-    {"CanQuit", "canQuit()"},
-    {"Fullscreen", "fullscreen()"},
-    {"CanSetFullscreen", "canSetFullscreen()"},
-    {"CanRaise", "canRaise()"},
-    {"HasTrackList", "hasTrackList()"},
-    {"Identity", "identity()"},
-    {"DesktopEntry", "desktopEntry()"},
-    {"SupportedUriSchemes", "supportedMimeTypes()"},
-    {"SupportedMimeTypes", "supportedUriSchemes()"},
-};
+namespace {
+    typedef QVariant (*PropertyGetter)(MprisPlayerPrivate *player);
+    typedef bool (*PropertySetter)(MprisPlayerPrivate *player, const QVariant &value);
+
+    struct PropertyDescriptor {
+        const char *name;
+        bool live;              // read on every GetAll, never cached
+        PropertyGetter get;
+        PropertySetter set;     // null for read-only properties
+    };
+
+    // Setters take the value only when the wire type matches exactly
+    const PropertyDescriptor playerProperties[] = {
+        { "CanControl", false, [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->canControl(); }, nullptr },
+        { "CanGoNext", false, [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->canGoNext(); }, nullptr },
+        { "CanGoPrevious", false, [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->canGoPrevious(); }, nullptr },
+        { "CanPause", false, [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->canPause(); }, nullptr },
+        { "CanPlay", false, [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->canPlay(); }, nullptr },
+        { "CanSeek", false, [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->canSeek(); }, nullptr },
+        { "LoopStatus", false,
+          [](MprisPlayerPrivate *p) -> QVariant { return p->loopStatus(); },
+          [](MprisPlayerPrivate *p, const QVariant &v) {
+              if (v.userType() != QMetaType::QString)
+                  return false;
+              p->setLoopStatus(v.toString());
+              return true;
+          } },
+        { "MaximumRate", false, [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->maximumRate(); }, nullptr },
+        { "Metadata", false, [](MprisPlayerPrivate *p) -> QVariant { return p->metaData(); }, nullptr },
+        { "MinimumRate", false, [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->minimumRate(); }, nullptr },
+        { "PlaybackStatus", false, [](MprisPlayerPrivate *p) -> QVariant { return p->playbackStatus(); }, nullptr },
+        { "Position", true, [](MprisPlayerPrivate *p) -> QVariant { return p->position(); }, nullptr },
+        { "Rate", false,
+          [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->rate(); },
+          [](MprisPlayerPrivate *p, const QVariant &v) {
+              if (v.userType() != QMetaType::Double)
+                  return false;
+              p->setRate(v.toDouble());
+              return true;
+          } },
+        { "Shuffle", false,
+          [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->shuffle(); },
+          [](MprisPlayerPrivate *p, const QVariant &v) {
+              if (v.userType() != QMetaType::Bool)
+                  return false;
+              p->setShuffle(v.toBool());
+              return true;
+          } },
+        { "Volume", false,
+          [](MprisPlayerPrivate *p) -> QVariant { return p->q_ptr->volume(); },
+          [](MprisPlayerPrivate *p, const QVariant &v) {
+              if (v.userType() != QMetaType::Double)
+                  return false;
+              p->setVolume(v.toDouble());
+              return true;
+          } },
+    };
+
+    const PropertyDescriptor serviceProperties[] = {
+        { "CanQuit", false, [](MprisPlayerPrivate *p) -> QVariant { return p->canQuit(); }, nullptr },
+        { "CanRaise", false, [](MprisPlayerPrivate *p) -> QVariant { return p->canRaise(); }, nullptr },
+        { "CanSetFullscreen", false, [](MprisPlayerPrivate *p) -> QVariant { return p->canSetFullscreen(); }, nullptr },
+        { "DesktopEntry", false, [](MprisPlayerPrivate *p) -> QVariant { return p->desktopEntry(); }, nullptr },
+        { "Fullscreen", false,
+          [](MprisPlayerPrivate *p) -> QVariant { return p->fullscreen(); },
+          [](MprisPlayerPrivate *p, const QVariant &v) {
+              if (v.userType() != QMetaType::Bool)
+                  return false;
+              p->setFullscreen(v.toBool());
+              return true;
+          } },
+        { "HasTrackList", false, [](MprisPlayerPrivate *p) -> QVariant { return p->hasTrackList(); }, nullptr },
+        { "Identity", false, [](MprisPlayerPrivate *p) -> QVariant { return p->identity(); }, nullptr },
+        { "SupportedMimeTypes", false, [](MprisPlayerPrivate *p) -> QVariant { return p->supportedMimeTypes(); }, nullptr },
+        { "SupportedUriSchemes", false, [](MprisPlayerPrivate *p) -> QVariant { return p->supportedUriSchemes(); }, nullptr },
+    };
+
+    struct InterfaceDescriptor {
+        int slot;               // of the GetAll reply cache
+        const PropertyDescriptor *begin;
+        const PropertyDescriptor *end;
+        QHash<QString, const PropertyDescriptor *> properties;
+        QVector<QString> names;     // in table order, shared by the GetAll replies
+    };
+
+    template<int N> InterfaceDescriptor describe(int slot, const PropertyDescriptor (&table)[N])
+    {
+        InterfaceDescriptor interface;
+        interface.slot = slot;
+        interface.begin = table;
+        interface.end = table + N;
+        interface.properties.reserve(N);
+        interface.names.reserve(N);
+        for (const PropertyDescriptor &property : table) {
+            const QString name = QString::fromLatin1(property.name);
+            interface.properties.insert(name, &property);
+            interface.names.append(name);
+        }
+        return interface;
+    }
 
-QDBusVariant MprisPropertiesAdaptor::Get(const QString &interface_name, const QString &property_name)
-{
-    QMap<QString, QString> getMap;
-    QVariant result;
+    const InterfaceDescriptor playerInterface = describe(0, playerProperties);
+    const InterfaceDescriptor serviceInterface = describe(1, serviceProperties);
 
-    if (interface_name == QLatin1String("org.mpris.MediaPlayer2.Player")) {
-        getMap = playerGetMap;
-    } else if (interface_name == QLatin1String("org.mpris.MediaPlayer2")) {
-        getMap = serviceGetMap;
+    const InterfaceDescriptor *interfaceDescriptor(const QString &interface_name)
+    {
+        if (interface_name == QLatin1String("org.mpris.MediaPlayer2.Player")) {
+            return &playerInterface;
+        } else if (interface_name == QLatin1String("org.mpris.MediaPlayer2")) {
+            return &serviceInterface;
+        }
+        return nullptr;
     }
 
-    const bool masked = m_maskedProperties.contains(property_name);
-    const QString &getter = masked ? QString() : getMap.value(property_name);
-    if (!getter.isEmpty()) {
-        result = get(getter);
-    } else {
-        replyPropertyNotFoundError(interface_name, property_name);
+    const PropertyDescriptor *propertyDescriptor(const InterfaceDescriptor *interface, const QString &property_name)
+    {
+        return interface ? interface->properties.value(property_name) : nullptr;
     }
-
-    return QDBusVariant(result);
 }
 
-QVariant MprisPropertiesAdaptor::get(const QString &getter)
+QDBusVariant MprisPropertiesAdaptor::Get(const QString &interface_name, const QString &property_name)
 {
     QVariant result;
 
-    // Start by checking MprisPlayerPrivate methods
-    int pidx = m_playerPrivate->metaObject()->indexOfMethod(
-                getter.toLocal8Bit().data());
-
-    if (pidx != -1) {
-        const QMetaMethod method = m_playerPrivate->metaObject()->method(pidx);
-        Q_ASSERT(method.parameterCount() == 0);
-
-        QMetaType returnType(method.returnType());
-        void * returnValue = returnType.create();
-        bool success = method.invoke(m_playerPrivate, Qt::DirectConnection,
-                                     QGenericReturnArgument(method.typeName(),
-                                                            returnValue));
-        if (success) {
-            // Conversion to QVariant will take a copy
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-            result = QVariant(returnType, returnValue);
-#else
-            result = QVariant(method.returnType(), returnValue);
-#endif
-        } else {
-            replyInternalError();
-        }
-        returnType.destroy(returnValue);
+    const PropertyDescriptor *property = propertyDescriptor(interfaceDescriptor(interface_name), property_name);
+    if (property && !m_maskedProperties.contains(property_name)) {
+        result = property->get(m_playerPrivate);
     } else {
-        // Nothing in MprisPlayerPrivate so check MprisPlayer properties instead
-        pidx = m_playerPrivate->q_ptr->metaObject()->indexOfProperty(
-                    getter.toLocal8Bit().data());
-
-        if (pidx != -1) {
-            QMetaProperty mp = m_playerPrivate->q_ptr->metaObject()->property(pidx);
-            result = mp.read(m_playerPrivate->q_ptr);
-        } else {
-            replyInternalError();
-        }
+        replyPropertyNotFoundError(interface_name, property_name);
     }
 
-    return result;
+    return QDBusVariant(result);
 }
 
 QVariantMap MprisPropertiesAdaptor::GetAll(const QString &interface_name)
 {
     QVariantMap result;
-    QMap<QString, QString> getMap;
 
     lockProperties();
 
-    if (interface_name == QLatin1String("org.mpris.MediaPlayer2.Player")) {
-        getMap = playerGetMap;
-    } else if (interface_name == QLatin1String("org.mpris.MediaPlayer2")) {
-        getMap = serviceGetMap;
-    } else {
+    const InterfaceDescriptor *interface = interfaceDescriptor(interface_name);
+    if (!interface) {
         replyPropertyNotFoundError(interface_name, "");
+        return result;
+    }
+
+    bool hit = false;
+    result = cachedProperties(interface_name, &hit);
+    if (hit) {
+        ++m_statistics.hits;
+    } else {
+        ++m_statistics.misses;
     }
 
-    QMap<QString, QString>::const_iterator it = getMap.constBegin();
-    while (it != getMap.constEnd()) {
-        if (!m_maskedProperties.contains(it.key())) {
-            QVariant value = get(it.value());
-            result.insert(it.key(), value);
+    for (const PropertyDescriptor *property = interface->begin; property != interface->end; ++property) {
+        const QString &name = interface->names.at(property - interface->begin);
+        if (property->live && !m_maskedProperties.contains(name)) {
+            result.insert(name, property->get(m_playerPrivate));
         }
-        ++it;
     }
 
     return result;
 }
 
-// Format: {DBus property name, method to call in MprisPlayerPrivate}
-static const QMap<QString, QString> playerSetMap
-{
-    {"LoopStatus", "setLoopStatus(QString)"},
-    {"Rate", "setRate(double)"},
-    {"Shuffle", "setShuffle(bool)"},
-    {"Volume", "setVolume(double)"},
-};
-
-static const QMap<QString, QString> serviceSetMap
-{
-    {"Fullscreen", "setFullscreen(bool)"},
-};
-
 void MprisPropertiesAdaptor::Set(const QString &interface_name, const QString &property_name, const QDBusVariant &value)
 {
-    QMap<QString, QString> setMap;
-    QMap<QString, QString> getMap;
-
-    if (interface_name == QLatin1String("org.mpris.MediaPlayer2.Player")) {
-        setMap = playerSetMap;
-        getMap = playerGetMap;
-    } else if (interface_name == QLatin1String("org.mpris.MediaPlayer2")) {
-        setMap = serviceSetMap;
-        getMap = serviceGetMap;
-    }
-
+    const PropertyDescriptor *property = propertyDescriptor(interfaceDescriptor(interface_name), property_name);
     const bool masked = m_maskedProperties.contains(property_name);
-    const QString &setter = masked ? QString() : setMap.value(property_name);
-    if (!setter.isEmpty()) {
-        set(setter, value);
-    } else {
-        if (!masked && getMap.contains(property_name)) {
-            replyPropertyReadOnlyError(interface_name, property_name);
-        } else {
-            replyPropertyNotFoundError(interface_name, property_name);
-        }
+
+    if (!property || masked) {
+        replyPropertyNotFoundError(interface_name, property_name);
+    } else if (!property->set) {
+        replyPropertyReadOnlyError(interface_name, property_name);
+    } else if (!property->set(m_playerPrivate, value.variant())) {
+        replyInternalError();
     }
 }
 
-void MprisPropertiesAdaptor::set(const QString &setter, const QDBusVariant &value)
+QVariantMap MprisPropertiesAdaptor::cachedProperties(const QString &interface_name, bool *hit)
 {
-    const QMetaObject *metaobject = m_playerPrivate->metaObject();
-    bool success = false;
-
-    int pidx = metaobject->indexOfMethod(
-                setter.toLocal8Bit().data());
+    const InterfaceDescriptor *interface = interfaceDescriptor(interface_name);
+    if (!interface) {
+        return QVariantMap();
+    }
 
-    if (pidx != -1) {
-        QMetaMethod method = metaobject->method(pidx);
-        Q_ASSERT(method.parameterCount() == 1);
+    CachedReply &cache = m_getAllCache[interface->slot];
+    const bool valid = cache.valid && cache.generation == m_playerPrivate->m_propertiesGeneration;
+    if (hit) {
+        *hit = valid;
+    }
+    if (valid) {
+        return cache.properties;
+    }
 
-        // QMetaType maps to Type, as long as our methods stick to the standard types
-        if (method.parameterType(0) == value.variant().userType()) {
-            success = method.invoke(m_playerPrivate, Qt::DirectConnection,
-                                    QGenericArgument(method.parameterNames()[0],
-                                                     value.variant().data()));
+    cache.properties.clear();
+    for (const PropertyDescriptor *property = interface->begin; property != interface->end; ++property) {
+        const QString &name = interface->names.at(property - interface->begin);
+        if (!property->live && !m_maskedProperties.contains(name)) {
+            cache.properties.insert(name, property->get(m_playerPrivate));
         }
     }
+    cache.generation = m_playerPrivate->m_propertiesGeneration;
+    cache.valid = true;
 
-    if (!success) {
-        replyInternalError();
-    }
+    return cache.properties;
 }
 
 bool MprisPropertiesAdaptor::propertiesLocked() const
@@ -261,17 +279,25 @@ bool MprisPropertiesAdaptor::propertiesLocked() const
 
 void MprisPropertiesAdaptor::hideProperty(const QString &property, bool hidden)
 {
+    if (hidden == m_maskedProperties.contains(property)) {
+        return;
+    }
+
     if (hidden) {
         m_maskedProperties.insert(property);
     } else {
         m_maskedProperties.remove(property);
     }
+
+    ++m_maskGeneration;
+    invalidateCache();
 }
 
 void MprisPropertiesAdaptor::reset()
 {
     // Caller is responsible for unregistering the object
     m_propertiesLocked = false;
+    invalidateCache();
 }
 
 bool MprisPropertiesAdaptor::hasMaskedProperties() const
@@ -284,6 +310,29 @@ bool MprisPropertiesAdaptor::propertyMasked(const QString &property) const
     return m_maskedProperties.contains(property);
 }
 
+QSet<QString> MprisPropertiesAdaptor::maskedProperties() const
+{
+    return m_maskedProperties;
+}
+
+quint64 MprisPropertiesAdaptor::maskGeneration() const
+{
+    return m_maskGeneration;
+}
+
+MprisPlayer::GetAllCacheStatistics MprisPropertiesAdaptor::statistics() const
+{
+    return m_statistics;
+}
+
+void MprisPropertiesAdaptor::invalidateCache()
+{
+    for (CachedReply &cache : m_getAllCache) {
+        cache.valid = false;
+        cache.properties.clear();
+    }
+}
+
 void MprisPropertiesAdaptor::lockProperties()
 {
     m_propertiesLocked = true;
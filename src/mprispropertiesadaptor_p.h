@@ -23,6 +23,8 @@
 #include <QtCore/QObject>
 #include <QtDBus/QtDBus>
 
+#include "mprisplayer.h"
+
 namespace Amber {
 
 class MprisPlayerPrivate;
@@ -75,6 +77,13 @@ public:
     void reset();
     bool hasMaskedProperties() const;
     bool propertyMasked(const QString &property) const;
+    QSet<QString> maskedProperties() const;
+    quint64 maskGeneration() const;     // bumped whenever the masked set changes
+
+    // The unmasked properties of the interface that are not read live
+    QVariantMap cachedProperties(const QString &interface_name, bool *hit = nullptr);
+
+    MprisPlayer::GetAllCacheStatistics statistics() const;
 
 public Q_SLOTS: // METHODS
     QDBusVariant Get(const QString &interface_name, const QString &property_name);
@@ -86,12 +95,23 @@ private:
     void replyPropertyReadOnlyError(const QString &interface_name, const QString &property_name);
     void replyInternalError();
 
-    QVariant get(const QString &getter);
-    void set(const QString &setter, const QDBusVariant &value);
+    void invalidateCache();
+
+    // Valid while the generation of the player properties matches
+    struct CachedReply {
+        CachedReply() : generation(0), valid(false) {}
+
+        quint64 generation;
+        bool valid;
+        QVariantMap properties;
+    };
 
     MprisPlayerPrivate *m_playerPrivate;
     bool m_propertiesLocked;
     QSet<QString> m_maskedProperties;
+    quint64 m_maskGeneration;
+    CachedReply m_getAllCache[2];   // player and service interface
+    MprisPlayer::GetAllCacheStatistics m_statistics;
 };
 }
 
@@ -18,6 +18,7 @@
  */
 
 
+#include <QDBusArgument>
 #include <QLoggingCategory>
 #include "mprisclient_p.h"
 
@@ -39,73 +40,106 @@ MprisRootInterface::MprisRootInterface(const QString &service, const QString &pa
     , m_fullscreen(false)
     , m_hasTrackList(false)
 {
-    connect(this, SIGNAL(propertyChanged(QString, QVariant)), this, SLOT(onPropertyChanged(QString, QVariant)));
+    Q_ASSERT(!qstrcmp(staticMetaObject.property(staticMetaObject.propertyOffset() + SupportedUriSchemesProperty).name(),
+                      "SupportedUriSchemes"));
+
+    // Every client has a root and a player interface on the same path,
+    // share one PropertiesChanged match rule among all of them.
+    setSharedPropertiesChanged(true);
+
+    // Changes are delivered through updateProperty(), connecting to the
+    // invalidation keeps the PropertiesChanged subscription in place.
+    connect(this, SIGNAL(propertyInvalidated(QString)), this, SLOT(onPropertyInvalidated(QString)));
 }
 
 MprisRootInterface::~MprisRootInterface()
 {
 }
 
-void MprisRootInterface::onPropertyChanged(const QString &propertyName, const QVariant &value)
+bool MprisRootInterface::updateProperty(int propertyIndex, const QVariant &value)
 {
-    if (propertyName == QStringLiteral("CanQuit")) {
+    switch (propertyIndex - staticMetaObject.propertyOffset()) {
+    case CanQuitProperty: {
         bool canQuit = value.toBool();
         if (m_canQuit != canQuit) {
             m_canQuit = canQuit;
             Q_EMIT canQuitChanged(m_canQuit);
         }
-    } else if (propertyName == QStringLiteral("CanRaise")) {
+        return true;
+    }
+    case CanRaiseProperty: {
         bool canRaise = value.toBool();
         if (m_canRaise != canRaise) {
             m_canRaise = canRaise;
             Q_EMIT canRaiseChanged(m_canRaise);
         }
-    } else if (propertyName == QStringLiteral("CanSetFullscreen")) {
+        return true;
+    }
+    case CanSetFullscreenProperty: {
         bool canSetFullscreen = value.toBool();
         if (m_canSetFullscreen != canSetFullscreen) {
             m_canSetFullscreen = canSetFullscreen;
             Q_EMIT canSetFullscreenChanged(m_canSetFullscreen);
         }
-    } else if (propertyName == QStringLiteral("DesktopEntry")) {
+        return true;
+    }
+    case DesktopEntryProperty: {
         QString desktopEntry = value.toString();
         if (m_desktopEntry != desktopEntry) {
             m_desktopEntry = desktopEntry;
             Q_EMIT desktopEntryChanged(m_desktopEntry);
         }
-    } else if (propertyName == QStringLiteral("Fullscreen")) {
+        return true;
+    }
+    case FullscreenProperty: {
         bool fullscreen = value.toBool();
         if (m_fullscreen != fullscreen) {
             m_fullscreen = fullscreen;
             Q_EMIT fullscreenChanged(m_fullscreen);
         }
-    } else if (propertyName == QStringLiteral("HasTrackList")) {
+        return true;
+    }
+    case HasTrackListProperty: {
         bool hasTrackList = value.toBool();
         if (m_hasTrackList != hasTrackList) {
             m_hasTrackList = hasTrackList;
             Q_EMIT hasTrackListChanged(m_hasTrackList);
         }
-    } else if (propertyName == QStringLiteral("Identity")) {
+        return true;
+    }
+    case IdentityProperty: {
         QString identity = value.toString();
         if (m_identity != identity) {
             m_identity = identity;
             Q_EMIT identityChanged(m_identity);
         }
-    } else if (propertyName == QStringLiteral("SupportedMimeTypes")) {
-        QStringList supportedUriSchemes = value.toStringList();
-        if (m_supportedUriSchemes != supportedUriSchemes) {
-            m_supportedUriSchemes = supportedUriSchemes;
-            Q_EMIT supportedMimeTypesChanged(m_supportedUriSchemes);
-        }
-    } else if (propertyName == QStringLiteral("SupportedUriSchemes")) {
-        QStringList supportedMimeTypes = value.toStringList();
+        return true;
+    }
+    case SupportedMimeTypesProperty: {
+        QStringList supportedMimeTypes = qdbus_cast<QStringList>(value);
         if (m_supportedMimeTypes != supportedMimeTypes) {
             m_supportedMimeTypes = supportedMimeTypes;
-            Q_EMIT supportedUriSchemesChanged(m_supportedMimeTypes);
+            Q_EMIT supportedMimeTypesChanged(m_supportedMimeTypes);
         }
-    } else {
+        return true;
+    }
+    case SupportedUriSchemesProperty: {
+        QStringList supportedUriSchemes = qdbus_cast<QStringList>(value);
+        if (m_supportedUriSchemes != supportedUriSchemes) {
+            m_supportedUriSchemes = supportedUriSchemes;
+            Q_EMIT supportedUriSchemesChanged(m_supportedUriSchemes);
+        }
+        return true;
+    }
+    default:
         qCWarning(lcIface) << Q_FUNC_INFO
                            << "Received PropertyChanged signal from unknown property: "
-                           << propertyName;
+                           << staticMetaObject.property(propertyIndex).name();
+        return false;
     }
 }
 
+void MprisRootInterface::onPropertyInvalidated(const QString &propertyName)
+{
+    qCDebug(lcIface) << Q_FUNC_INFO << "Property" << propertyName << "invalidated";
+}
@@ -0,0 +1,229 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "mprisservicediscovery_p.h"
+
+#include "ambermpris_p.h"
+
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+
+#include <QDebug>
+#include <QLoggingCategory>
+
+using namespace Amber;
+
+namespace {
+    const QString mprisNameSpace = QStringLiteral("org.mpris.MediaPlayer2.");
+    const QString dBusService = QStringLiteral("org.freedesktop.DBus");
+    const QString dBusObjectPath = QStringLiteral("/org/freedesktop/DBus");
+    const QString dBusInterface = QStringLiteral("org.freedesktop.DBus");
+    const QString dBusNameOwnerChangedSignal = QStringLiteral("NameOwnerChanged");
+    const QString dBusAddMatchMethod = QStringLiteral("AddMatch");
+    const QString dBusRemoveMatchMethod = QStringLiteral("RemoveMatch");
+    const QString dBusListNamesMethod = QStringLiteral("ListNames");
+
+    // The rule QDBusConnection::connect() installs for our hook. QtDBus
+    // shares one daemon side rule between identical hooks of a connection,
+    // so it may only be removed on a connection nobody else hooks into.
+    const QString broadMatchRule = QStringLiteral(
+            "type='signal',"
+            "path='/org/freedesktop/DBus',"
+            "interface='org.freedesktop.DBus',"
+            "member='NameOwnerChanged'");
+    const QString nameSpaceMatchRule = QStringLiteral(
+            "type='signal',"
+            "sender='org.freedesktop.DBus',"
+            "path='/org/freedesktop/DBus',"
+            "interface='org.freedesktop.DBus',"
+            "member='NameOwnerChanged',"
+            "arg0namespace='org.mpris.MediaPlayer2'");
+
+    const QString discoveryConnectionName = QStringLiteral("org.amber.mpris.discovery");
+
+    Q_LOGGING_CATEGORY(lcDiscovery, "org.amber.mpris.discovery", QtWarningMsg)
+
+    MprisServiceDiscovery *s_instance = nullptr;
+}
+
+MprisServiceDiscovery::MprisServiceDiscovery()
+    : QObject(nullptr)
+    , m_connection(QDBusConnection::connectToBus(dbusConnectionType(), discoveryConnectionName))
+    , m_refCount(0)
+    , m_nameSpaceMatch(false)
+    , m_ready(false)
+{
+    if (!m_connection.isConnected()) {
+        qCWarning(lcDiscovery) << "Mpris: Failed attempting to connect to DBus";
+        m_ready = true;
+        return;
+    }
+
+    // The hook has to exist before the daemon side rule is narrowed,
+    // otherwise the signals would be delivered but never dispatched.
+    m_connection.connect(QString(), dBusObjectPath, dBusInterface, dBusNameOwnerChangedSignal,
+                         QStringList(), QString(),
+                         this, SLOT(onNameOwnerChanged(QString, QString, QString, QDBusMessage)));
+
+    QDBusMessage message = QDBusMessage::createMethodCall(dBusService, dBusObjectPath,
+                                                          dBusInterface, dBusAddMatchMethod);
+    message << nameSpaceMatchRule;
+
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_connection.asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &MprisServiceDiscovery::onNameSpaceMatchFinished);
+
+    // Sent after the hook got installed, so any change not reflected
+    // in the reply is delivered after it.
+    message = QDBusMessage::createMethodCall(dBusService, dBusObjectPath,
+                                             dBusInterface, dBusListNamesMethod);
+    watcher = new QDBusPendingCallWatcher(m_connection.asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &MprisServiceDiscovery::onListNamesFinished);
+}
+
+MprisServiceDiscovery::~MprisServiceDiscovery()
+{
+    // The daemon drops the rules of the connection with it
+    QDBusConnection::disconnectFromBus(discoveryConnectionName);
+}
+
+MprisServiceDiscovery *MprisServiceDiscovery::acquire()
+{
+    if (!s_instance) {
+        s_instance = new MprisServiceDiscovery;
+    }
+
+    ++s_instance->m_refCount;
+    return s_instance;
+}
+
+void MprisServiceDiscovery::release()
+{
+    Q_ASSERT(this == s_instance && m_refCount > 0);
+
+    if (!--m_refCount) {
+        s_instance = nullptr;
+        delete this;
+    }
+}
+
+bool MprisServiceDiscovery::nameSpaceMatch() const
+{
+    return m_nameSpaceMatch;
+}
+
+bool MprisServiceDiscovery::isReady() const
+{
+    return m_ready;
+}
+
+QStringList MprisServiceDiscovery::services() const
+{
+    return m_services.values();
+}
+
+void MprisServiceDiscovery::onNameOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner, const QDBusMessage &message)
+{
+    // The hook is sender-less, don't trust anybody but the bus daemon.
+    if (message.service() != dBusService) {
+        return;
+    }
+
+    // Only needed when the daemon didn't take the arg0namespace rule,
+    // but cheap enough to keep unconditionally.
+    if (!service.startsWith(mprisNameSpace)) {
+        return;
+    }
+
+    if (oldOwner.isEmpty()) {
+        m_services.insert(service);
+        Q_EMIT serviceAppeared(service);
+        return;
+    }
+
+    if (newOwner.isEmpty()) {
+        m_services.remove(service);
+        Q_EMIT serviceVanished(service);
+        return;
+    }
+
+    // Service changed owner. Nothing to do ...
+}
+
+void MprisServiceDiscovery::onNameSpaceMatchFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isError()) {
+        qCDebug(lcDiscovery) << "Mpris: Bus daemon doesn't support arg0namespace, filtering names in user space:"
+                             << reply.error().message();
+        return;
+    }
+
+    // Both rules are active at this point and a message matching both is
+    // delivered only once, so there is no gap nor duplicates. The broad
+    // rule is ours alone, the connection is private to the discovery.
+    m_nameSpaceMatch = true;
+    callMatchMethod(dBusRemoveMatchMethod, broadMatchRule);
+}
+
+void MprisServiceDiscovery::onListNamesFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<QStringList> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isError()) {
+        qCWarning(lcDiscovery) << "Mpris: Failed to list the registered services:" << reply.error().message();
+    } else {
+        // Name changes received before the reply are already reflected
+        // in it, so the reply is the current state of the bus.
+        QSet<QString> services;
+        const QStringList names = reply.value();
+        for (const QString &name : names) {
+            if (name.startsWith(mprisNameSpace)) {
+                services.insert(name);
+            }
+        }
+
+        const QSet<QString> vanished = m_services - services;
+        const QSet<QString> appeared = services - m_services;
+        m_services = services;
+
+        for (const QString &service : vanished) {
+            Q_EMIT serviceVanished(service);
+        }
+        for (const QString &service : appeared) {
+            Q_EMIT serviceAppeared(service);
+        }
+    }
+
+    m_ready = true;
+    Q_EMIT ready();
+}
+
+void MprisServiceDiscovery::callMatchMethod(const QString &method, const QString &rule)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(dBusService, dBusObjectPath,
+                                                          dBusInterface, method);
+    message << rule;
+    m_connection.send(message);
+}
@@ -0,0 +1,104 @@
+/*
+ *
+ * Copyright (C) 2015-2023 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the public API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+//
+
+
+#ifndef MPRISSERVICEDISCOVERY_P_H
+#define MPRISSERVICEDISCOVERY_P_H
+
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+
+namespace Amber {
+
+/*
+ * Watches the bus for Mpris2 services appearing and vanishing.
+ *
+ * QtDBus cannot express an arg0namespace match, so the NameOwnerChanged
+ * hook is installed through QDBusConnection (which adds a broad match
+ * rule to the bus daemon) and then the broad rule is swapped for a
+ * daemon side "arg0namespace='org.mpris.MediaPlayer2'" rule through raw
+ * AddMatch / RemoveMatch calls. If the daemon rejects arg0namespace the
+ * broad rule is kept and the names are filtered in user space.
+ *
+ * The swap uses a bus connection of its own. QtDBus shares the broad
+ * rule with every identical hook on a connection, removing it from the
+ * shared one would silence NameOwnerChanged hooks elsewhere in the
+ * process.
+ *
+ * The currently registered services are enumerated once with an
+ * asynchronous ListNames call, ready() is emitted when that is done.
+ *
+ * The instance is shared by every controller in the process and must
+ * only be used from a single thread.
+ */
+class MprisServiceDiscovery : public QObject
+{
+    Q_OBJECT
+
+public:
+    static MprisServiceDiscovery *acquire();
+    void release();
+
+    bool nameSpaceMatch() const;
+    bool isReady() const;
+    QStringList services() const;
+
+Q_SIGNALS:
+    void ready();
+    void serviceAppeared(const QString &service);
+    void serviceVanished(const QString &service);
+
+private Q_SLOTS:
+    void onNameOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner, const QDBusMessage &message);
+    void onNameSpaceMatchFinished(QDBusPendingCallWatcher *watcher);
+    void onListNamesFinished(QDBusPendingCallWatcher *watcher);
+
+private:
+    MprisServiceDiscovery();
+    ~MprisServiceDiscovery();
+
+    void callMatchMethod(const QString &method, const QString &rule);
+
+    QDBusConnection m_connection;
+    unsigned m_refCount;
+    bool m_nameSpaceMatch;
+    bool m_ready;
+    QSet<QString> m_services;
+};
+
+}
+
+#endif
@@ -25,6 +25,8 @@ CONFIG += create_pc create_prl no_install_prl
 SOURCES += \
     mpris.cpp \
     mprisclient.cpp \
+    mprisclientmodel.cpp \
+    mprisclientregistry.cpp \
     mpriscontroller.cpp \
     mprisintrospectableadaptor.cpp \
     mprismetadata.cpp \
@@ -32,15 +34,21 @@ SOURCES += \
     mprisplayer.cpp \
     mprisplayeradaptor.cpp \
     mprisplayerinterface.cpp \
+    mprisplayerservice.cpp \
+    mprispositionclock.cpp \
+    mprispositionestimator.cpp \
     mprispropertiesadaptor.cpp \
     mprisrootinterface.cpp \
-    mprisserviceadaptor.cpp
+    mprisserviceadaptor.cpp \
+    mprisservicediscovery.cpp
 
 HEADERS += \
     mpris.h \
     mpris_p.h \
     mprisclient.h \
     mprisclient_p.h \
+    mprisclientmodel_p.h \
+    mprisclientregistry_p.h \
     mpriscontroller.h \
     mprisintrospectableadaptor_p.h \
     mprismetadata.h \
@@ -49,10 +57,14 @@ HEADERS += \
     mprisplayeradaptor_p.h \
     mprisplayer.h \
     mprisplayer_p.h \
+    mprisplayerservice_p.h \
+    mprispositionclock_p.h \
+    mprispositionestimator_p.h \
     ambermpris.h \
     ambermpris_p.h \
     mprispropertiesadaptor_p.h \
-    mprisserviceadaptor_p.h
+    mprisserviceadaptor_p.h \
+    mprisservicediscovery_p.h
 
 INSTALL_HEADERS = \
     Mpris \
@@ -0,0 +1,56 @@
+/*
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+
+#include <functional>
+
+namespace Benchmark {
+
+// Runs the event loop until the condition holds. Unlike QTRY_VERIFY it
+// returns as soon as the event that satisfies it has been processed, the
+// wake up timer only bounds the wait when nothing arrives.
+inline bool waitFor(const std::function<bool()> &condition, int timeout = 5000)
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    QTimer wakeUp;
+    wakeUp.start(100);
+
+    while (!condition()) {
+        if (elapsed.hasExpired(timeout)) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+
+    return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,15 @@
+include(../../common.pri)
+
+TEMPLATE = app
+CONFIG += qt testcase no_testcase_installs
+
+QT = core dbus testlib
+
+DEPENDPATH += $$PWD $$PWD/../../src $$PWD/../../qtdbusextended
+INCLUDEPATH += $$PWD $$PWD/../../src $$PWD/../../qtdbusextended
+
+HEADERS += \
+    $$PWD/benchmark.h
+
+# The benchmarks run from the build tree
+QMAKE_RPATHDIR += $$OUT_PWD/../../../src
@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+SUBDIRS = \
+    controllerstatus \
+    controllerswitch \
+    propertiesadaptor \
+    propertieschanged
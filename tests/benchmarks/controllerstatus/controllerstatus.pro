@@ -0,0 +1,8 @@
+include(../benchmark.pri)
+
+TARGET = tst_controllerstatus
+
+LIBS += -L../../../src -l$${MPRISQTLIB}
+
+SOURCES += \
+    tst_controllerstatus.cpp
@@ -0,0 +1,134 @@
+/*
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "benchmark.h"
+
+#include <Mpris>
+#include <MprisClient>
+#include <MprisController>
+#include <MprisPlayer>
+
+#include <QDBusConnection>
+#include <QtTest>
+
+#include <sys/resource.h>
+
+using namespace Amber;
+
+class tst_ControllerStatus : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void statusFlips();
+
+private:
+    QList<MprisPlayer *> m_players;
+    QList<MprisClient *> m_clients;
+    MprisController *m_controller = nullptr;
+};
+
+void tst_ControllerStatus::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("No session bus, run under dbus-run-session");
+    }
+
+    bool ok = false;
+    int count = qEnvironmentVariableIntValue("AMBER_MPRIS_BENCHMARK_PLAYERS", &ok);
+    if (!ok || count <= 0) {
+        count = 1000;
+    }
+
+    // Every player has a bus connection of its own
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        MprisPlayer *player = new MprisPlayer(this);
+        player->setServiceName(QStringLiteral("benchmark%1").arg(i));
+        player->setIdentity(QStringLiteral("Benchmark %1").arg(i));
+        player->setCanControl(true);
+        player->setCanPlay(true);
+        player->setCanPause(true);
+        player->setPlaybackStatus(Mpris::Paused);
+        m_players.append(player);
+    }
+
+    m_controller = new MprisController(this);
+    QVERIFY(Benchmark::waitFor([this, count] {
+        return m_controller->isReady() && m_controller->availableServices().count() == count;
+    }, 120000));
+
+    // Keeps the current player, the switches are measured on their own
+    m_controller->setSingleService(true);
+
+    QHash<QString, MprisClient *> clients;
+    for (QObject *object : m_controller->availableClients()) {
+        MprisClient *client = qobject_cast<MprisClient *>(object);
+        QVERIFY(client);
+        clients.insert(client->service(), client);
+    }
+
+    for (MprisPlayer *player : m_players) {
+        MprisClient *client = clients.value(player->serviceName());
+        QVERIFY(client);
+        m_clients.append(client);
+    }
+}
+
+void tst_ControllerStatus::cleanupTestCase()
+{
+    delete m_controller;
+    m_controller = nullptr;
+    qDeleteAll(m_players);
+    m_players.clear();
+}
+
+// One status change of one player, from the player to the controller
+// having reordered its lists. The players are flipped in turn, between
+// two flips of the same player there are as many flips of the others,
+// which keeps the players out of their PropertiesChanged rate limit.
+void tst_ControllerStatus::statusFlips()
+{
+    int i = 0;
+
+    QBENCHMARK {
+        MprisPlayer *player = m_players.at(i);
+        MprisClient *client = m_clients.at(i);
+
+        const Mpris::PlaybackStatus status = player->playbackStatus() == Mpris::Playing
+                ? Mpris::Paused : Mpris::Playing;
+        player->setPlaybackStatus(status);
+        QVERIFY(Benchmark::waitFor([client, status] { return client->playbackStatus() == status; }));
+
+        i = (i + 1) % m_players.count();
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_ControllerStatus)
+
+#include "tst_controllerstatus.moc"
@@ -0,0 +1,8 @@
+include(../benchmark.pri)
+
+TARGET = tst_controllerswitch
+
+LIBS += -L../../../src -l$${MPRISQTLIB}
+
+SOURCES += \
+    tst_controllerswitch.cpp
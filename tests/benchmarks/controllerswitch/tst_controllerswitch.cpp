@@ -0,0 +1,199 @@
+/*
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "benchmark.h"
+
+#include <Mpris>
+#include <MprisController>
+#include <MprisMetaData>
+#include <MprisPlayer>
+
+#include <QDBusConnection>
+#include <QtTest>
+
+using namespace Amber;
+
+class tst_ControllerSwitch : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_ControllerSwitch();
+
+public Q_SLOTS:
+    // Stands for the bindings of a QML user
+    void onControllerSignal();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void switchCurrent_data();
+    void switchCurrent();
+
+private:
+    bool isCurrent(MprisPlayer *player) const;
+
+    MprisPlayer *m_music;
+    MprisPlayer *m_podcast;
+    MprisController *m_controller;
+    int m_signalCount;
+};
+
+tst_ControllerSwitch::tst_ControllerSwitch()
+    : m_music(nullptr)
+    , m_podcast(nullptr)
+    , m_controller(nullptr)
+    , m_signalCount(0)
+{
+}
+
+void tst_ControllerSwitch::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("No session bus, run under dbus-run-session");
+    }
+
+    // Different values for most of the forwarded state, so a switch
+    // changes as much as it can
+    m_music = new MprisPlayer(this);
+    m_music->setServiceName(QStringLiteral("benchmarkmusic"));
+    m_music->setIdentity(QStringLiteral("Music"));
+    m_music->setDesktopEntry(QStringLiteral("benchmark-music"));
+    m_music->setSupportedMimeTypes(QStringList() << QStringLiteral("audio/mpeg") << QStringLiteral("audio/ogg"));
+    m_music->setCanControl(true);
+    m_music->setCanGoNext(true);
+    m_music->setCanGoPrevious(true);
+    m_music->setCanPlay(true);
+    m_music->setCanPause(true);
+    m_music->setCanSeek(true);
+    m_music->setHasShuffle(true);
+    m_music->setHasLoopStatus(true);
+    m_music->setLoopStatus(Mpris::LoopPlaylist);
+    m_music->setShuffle(true);
+    m_music->setVolume(0.3);
+    m_music->setPlaybackStatus(Mpris::Playing);
+    m_music->metaData()->setTitle(QStringLiteral("Song"));
+
+    m_podcast = new MprisPlayer(this);
+    m_podcast->setServiceName(QStringLiteral("benchmarkpodcast"));
+    m_podcast->setIdentity(QStringLiteral("Podcasts"));
+    m_podcast->setDesktopEntry(QStringLiteral("benchmark-podcast"));
+    m_podcast->setSupportedMimeTypes(QStringList() << QStringLiteral("audio/mpeg"));
+    m_podcast->setCanControl(true);
+    m_podcast->setCanPlay(true);
+    m_podcast->setCanPause(true);
+    m_podcast->setCanSeek(true);
+    m_podcast->setMaximumRate(2.0);
+    m_podcast->setRate(1.5);
+    m_podcast->setVolume(0.8);
+    m_podcast->setPlaybackStatus(Mpris::Paused);
+    m_podcast->metaData()->setTitle(QStringLiteral("Episode"));
+
+    m_controller = new MprisController(this);
+    QVERIFY(Benchmark::waitFor([this] {
+        return m_controller->isReady() && m_controller->availableServices().count() == 2;
+    }));
+
+    // Switches are made by hand only
+    m_controller->setSingleService(true);
+
+    // Both clients are tracked in full after having been current once
+    m_controller->setCurrentService(m_podcast->serviceName());
+    QVERIFY(Benchmark::waitFor([this] { return isCurrent(m_podcast); }));
+    m_controller->setCurrentService(m_music->serviceName());
+    QVERIFY(Benchmark::waitFor([this] { return isCurrent(m_music); }));
+}
+
+void tst_ControllerSwitch::cleanupTestCase()
+{
+    delete m_controller;
+    m_controller = nullptr;
+    delete m_music;
+    m_music = nullptr;
+    delete m_podcast;
+    m_podcast = nullptr;
+}
+
+void tst_ControllerSwitch::switchCurrent_data()
+{
+    QTest::addColumn<bool>("listeners");
+
+    QTest::newRow("no listeners") << false;
+    QTest::newRow("all signals connected") << true;
+}
+
+// One switch of the current service between two fully tracked clients,
+// including the change signals it emits
+void tst_ControllerSwitch::switchCurrent()
+{
+    QFETCH(bool, listeners);
+
+    const QMetaObject *metaObject = m_controller->metaObject();
+    const QMetaMethod slot = staticMetaObject.method(staticMetaObject.indexOfSlot("onControllerSignal()"));
+    QList<QMetaObject::Connection> connections;
+
+    if (listeners) {
+        for (int i = metaObject->methodOffset(); i < metaObject->methodCount(); ++i) {
+            const QMetaMethod method = metaObject->method(i);
+            if (method.methodType() == QMetaMethod::Signal) {
+                connections.append(connect(m_controller, method, this, slot));
+            }
+        }
+    }
+
+    m_signalCount = 0;
+
+    const QString music = m_music->serviceName();
+    const QString podcast = m_podcast->serviceName();
+    bool flip = false;
+
+    QBENCHMARK {
+        m_controller->setCurrentService(flip ? music : podcast);
+        flip = !flip;
+    }
+
+    QVERIFY(isCurrent(flip ? m_podcast : m_music));
+    QVERIFY(!listeners || m_signalCount > 0);
+
+    for (const QMetaObject::Connection &connection : connections) {
+        disconnect(connection);
+    }
+
+    // Leave the music player current for the next row
+    m_controller->setCurrentService(music);
+}
+
+void tst_ControllerSwitch::onControllerSignal()
+{
+    ++m_signalCount;
+}
+
+bool tst_ControllerSwitch::isCurrent(MprisPlayer *player) const
+{
+    return m_controller->currentService() == player->serviceName()
+            && m_controller->identity() == player->identity()
+            && m_controller->volume() == player->volume()
+            && m_controller->metaData()->title() == player->metaData()->title();
+}
+
+QTEST_GUILESS_MAIN(tst_ControllerSwitch)
+
+#include "tst_controllerswitch.moc"
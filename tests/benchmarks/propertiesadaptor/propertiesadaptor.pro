@@ -0,0 +1,8 @@
+include(../benchmark.pri)
+
+TARGET = tst_propertiesadaptor
+
+LIBS += -L../../../src -l$${MPRISQTLIB}
+
+SOURCES += \
+    tst_propertiesadaptor.cpp
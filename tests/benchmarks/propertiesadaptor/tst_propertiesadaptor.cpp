@@ -0,0 +1,224 @@
+/*
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "benchmark.h"
+
+#include <Mpris>
+#include <MprisMetaData>
+#include <MprisPlayer>
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QtTest>
+
+using namespace Amber;
+
+namespace {
+const QString mprisObjectPath = QStringLiteral("/org/mpris/MediaPlayer2");
+const QString propertiesInterface = QStringLiteral("org.freedesktop.DBus.Properties");
+const QString rootInterface = QStringLiteral("org.mpris.MediaPlayer2");
+const QString playerInterface = QStringLiteral("org.mpris.MediaPlayer2.Player");
+}
+
+class tst_PropertiesAdaptor : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_PropertiesAdaptor();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void get_data();
+    void get();
+    void getAll_data();
+    void getAll();
+
+private:
+    void addRows(const QList<QStringList> &calls);
+    bool call(const QDBusMessage &message, int batch);
+    MprisPlayer *createPlayer(const QString &serviceName);
+
+    QDBusConnection m_connection;
+    MprisPlayer *m_player;
+    MprisPlayer *m_threadedPlayer;
+};
+
+tst_PropertiesAdaptor::tst_PropertiesAdaptor()
+    : m_connection(QStringLiteral("tst_propertiesadaptor"))
+    , m_player(nullptr)
+    , m_threadedPlayer(nullptr)
+{
+}
+
+void tst_PropertiesAdaptor::initTestCase()
+{
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("No session bus, run under dbus-run-session");
+    }
+
+    // The calls go through the daemon like the ones of other processes,
+    // the connections of the players are never the caller's
+    m_connection = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral("tst_propertiesadaptor"));
+    QVERIFY(m_connection.isConnected());
+
+    m_player = createPlayer(QStringLiteral("benchmarkplayer"));
+
+    MprisPlayer::setServiceThreadEnabled(true);
+    m_threadedPlayer = createPlayer(QStringLiteral("benchmarkthreadedplayer"));
+    MprisPlayer::setServiceThreadEnabled(false);
+}
+
+void tst_PropertiesAdaptor::cleanupTestCase()
+{
+    delete m_player;
+    m_player = nullptr;
+    delete m_threadedPlayer;
+    m_threadedPlayer = nullptr;
+    QDBusConnection::disconnectFromBus(m_connection.name());
+}
+
+MprisPlayer *tst_PropertiesAdaptor::createPlayer(const QString &serviceName)
+{
+    MprisPlayer *player = new MprisPlayer(this);
+    player->setServiceName(serviceName);
+    player->setIdentity(QStringLiteral("Benchmark"));
+    player->setDesktopEntry(QStringLiteral("benchmark"));
+    player->setSupportedUriSchemes(QStringList() << QStringLiteral("file") << QStringLiteral("http"));
+    player->setSupportedMimeTypes(QStringList() << QStringLiteral("audio/mpeg") << QStringLiteral("audio/ogg"));
+    player->setCanControl(true);
+    player->setCanGoNext(true);
+    player->setCanPlay(true);
+    player->setCanPause(true);
+    player->setCanSeek(true);
+    player->setPlaybackStatus(Mpris::Playing);
+    player->setPositionSnapshot(Q_INT64_C(30000000));
+
+    MprisMetaData *metaData = player->metaData();
+    metaData->setTrackId(QStringLiteral("/org/example/track/1"));
+    metaData->setTitle(QStringLiteral("Title"));
+    metaData->setAlbumTitle(QStringLiteral("Album"));
+    metaData->setContributingArtist(QStringList() << QStringLiteral("Artist"));
+    metaData->setDuration(Q_INT64_C(180000000));
+    metaData->setTrackNumber(3);
+
+    return player;
+}
+
+void tst_PropertiesAdaptor::addRows(const QList<QStringList> &calls)
+{
+    QTest::addColumn<bool>("threaded");
+    QTest::addColumn<QString>("interface");
+    QTest::addColumn<QString>("property");
+    QTest::addColumn<int>("batch");
+
+    // One call at a time gives the round trip, a batch of calls in flight
+    // together the throughput of the player
+    for (int threaded = 0; threaded < 2; ++threaded) {
+        for (const QStringList &call : calls) {
+            for (int batch : { 1, 100 }) {
+                const QString name = QStringLiteral("%1, %2, %3")
+                        .arg(threaded ? QStringLiteral("service thread") : QStringLiteral("player thread"))
+                        .arg(call.last())
+                        .arg(batch == 1 ? QStringLiteral("sequential") : QStringLiteral("%1 in flight").arg(batch));
+                QTest::newRow(name.toLatin1().constData()) << bool(threaded) << call.first() << call.value(1) << batch;
+            }
+        }
+    }
+}
+
+bool tst_PropertiesAdaptor::call(const QDBusMessage &message, int batch)
+{
+    // Owns the watchers, the replies still on their way when waiting
+    // times out are dropped with it
+    QObject context;
+    int pending = batch;
+    int errors = 0;
+
+    for (int i = 0; i < batch; ++i) {
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_connection.asyncCall(message), &context);
+        connect(watcher, &QDBusPendingCallWatcher::finished, &context, [&pending, &errors, watcher] {
+            if (watcher->isError()) {
+                ++errors;
+            }
+            --pending;
+        });
+    }
+
+    return Benchmark::waitFor([&pending] { return pending == 0; }) && errors == 0;
+}
+
+void tst_PropertiesAdaptor::get_data()
+{
+    addRows(QList<QStringList>()
+            << (QStringList() << rootInterface << QStringLiteral("Identity"))
+            << (QStringList() << playerInterface << QStringLiteral("PlaybackStatus"))
+            << (QStringList() << playerInterface << QStringLiteral("Metadata"))
+            << (QStringList() << playerInterface << QStringLiteral("Position")));
+}
+
+void tst_PropertiesAdaptor::get()
+{
+    QFETCH(bool, threaded);
+    QFETCH(QString, interface);
+    QFETCH(QString, property);
+    QFETCH(int, batch);
+
+    QDBusMessage message = QDBusMessage::createMethodCall(
+                (threaded ? m_threadedPlayer : m_player)->serviceName(),
+                mprisObjectPath, propertiesInterface, QStringLiteral("Get"));
+    message << interface << property;
+
+    QBENCHMARK {
+        QVERIFY(call(message, batch));
+    }
+}
+
+// Repeated GetAll calls are answered from the reply cache of the player
+// while its properties don't change
+void tst_PropertiesAdaptor::getAll_data()
+{
+    addRows(QList<QStringList>()
+            << (QStringList() << rootInterface)
+            << (QStringList() << playerInterface));
+}
+
+void tst_PropertiesAdaptor::getAll()
+{
+    QFETCH(bool, threaded);
+    QFETCH(QString, interface);
+    QFETCH(int, batch);
+
+    QDBusMessage message = QDBusMessage::createMethodCall(
+                (threaded ? m_threadedPlayer : m_player)->serviceName(),
+                mprisObjectPath, propertiesInterface, QStringLiteral("GetAll"));
+    message << interface;
+
+    QBENCHMARK {
+        QVERIFY(call(message, batch));
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_PropertiesAdaptor)
+
+#include "tst_propertiesadaptor.moc"
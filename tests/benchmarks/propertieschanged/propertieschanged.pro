@@ -0,0 +1,8 @@
+include(../benchmark.pri)
+
+TARGET = tst_propertieschanged
+
+LIBS += -L../../../qtdbusextended -ldbusextended-qt5
+
+SOURCES += \
+    tst_propertieschanged.cpp
@@ -0,0 +1,266 @@
+/*
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "dbusextendedabstractinterface.h"
+
+#include <QtTest>
+
+using namespace Amber::Private;
+
+namespace {
+const char *benchmarkInterfaceName = "org.example.Benchmark";
+}
+
+class BenchmarkInterface : public DBusExtendedAbstractInterface
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool CanPlay READ canPlay NOTIFY canPlayChanged)
+    Q_PROPERTY(bool CanPause READ canPause NOTIFY canPauseChanged)
+    Q_PROPERTY(QString PlaybackStatus READ playbackStatus NOTIFY playbackStatusChanged)
+    Q_PROPERTY(qlonglong Position READ position NOTIFY positionChanged)
+    Q_PROPERTY(double Rate READ rate NOTIFY rateChanged)
+    Q_PROPERTY(double Volume READ volume NOTIFY volumeChanged)
+    Q_PROPERTY(QStringList SupportedMimeTypes READ supportedMimeTypes NOTIFY supportedMimeTypesChanged)
+
+public:
+    enum Property {
+        CanPlayProperty,
+        CanPauseProperty,
+        PlaybackStatusProperty,
+        PositionProperty,
+        RateProperty,
+        VolumeProperty,
+        SupportedMimeTypesProperty
+    };
+
+    // Without the typed fast path every change goes through the
+    // demarshalled propertyChanged() signal
+    BenchmarkInterface(const QDBusConnection &connection, bool typed)
+        : DBusExtendedAbstractInterface(QString(), QStringLiteral("/org/example/Benchmark"),
+                                        benchmarkInterfaceName, connection, nullptr)
+        , m_typed(typed)
+        , m_canPlay(false)
+        , m_canPause(false)
+        , m_position(0)
+        , m_rate(1.0)
+        , m_volume(1.0)
+    {
+        setUseCache(true);
+    }
+
+    bool canPlay() const { return m_canPlay; }
+    bool canPause() const { return m_canPause; }
+    QString playbackStatus() const { return m_playbackStatus; }
+    qlonglong position() const { return m_position; }
+    double rate() const { return m_rate; }
+    double volume() const { return m_volume; }
+    QStringList supportedMimeTypes() const { return m_supportedMimeTypes; }
+
+Q_SIGNALS:
+    void canPlayChanged(bool canPlay);
+    void canPauseChanged(bool canPause);
+    void playbackStatusChanged(const QString &playbackStatus);
+    void positionChanged(qlonglong position);
+    void rateChanged(double rate);
+    void volumeChanged(double volume);
+    void supportedMimeTypesChanged(const QStringList &supportedMimeTypes);
+
+protected:
+    bool updateProperty(int propertyIndex, const QVariant &value)
+    {
+        if (!m_typed) {
+            return false;
+        }
+
+        switch (propertyIndex - staticMetaObject.propertyOffset()) {
+        case CanPlayProperty:
+            m_canPlay = value.toBool();
+            Q_EMIT canPlayChanged(m_canPlay);
+            return true;
+        case CanPauseProperty:
+            m_canPause = value.toBool();
+            Q_EMIT canPauseChanged(m_canPause);
+            return true;
+        case PlaybackStatusProperty:
+            m_playbackStatus = value.toString();
+            Q_EMIT playbackStatusChanged(m_playbackStatus);
+            return true;
+        case PositionProperty:
+            m_position = value.toLongLong();
+            Q_EMIT positionChanged(m_position);
+            return true;
+        case RateProperty:
+            m_rate = value.toDouble();
+            Q_EMIT rateChanged(m_rate);
+            return true;
+        case VolumeProperty:
+            m_volume = value.toDouble();
+            Q_EMIT volumeChanged(m_volume);
+            return true;
+        case SupportedMimeTypesProperty:
+            m_supportedMimeTypes = value.toStringList();
+            Q_EMIT supportedMimeTypesChanged(m_supportedMimeTypes);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+private:
+    bool m_typed;
+    bool m_canPlay;
+    bool m_canPause;
+    QString m_playbackStatus;
+    qlonglong m_position;
+    double m_rate;
+    double m_volume;
+    QStringList m_supportedMimeTypes;
+};
+
+class tst_PropertiesChanged : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_PropertiesChanged();
+
+private Q_SLOTS:
+    void dispatch_data();
+    void dispatch();
+    void lookup_data();
+    void lookup();
+
+private:
+    static QVariantMap changes(int count, bool playing);
+
+    // Never connected, nothing is sent or received on it
+    QDBusConnection m_connection;
+};
+
+tst_PropertiesChanged::tst_PropertiesChanged()
+    : m_connection(QStringLiteral("tst_propertieschanged"))
+{
+}
+
+QVariantMap tst_PropertiesChanged::changes(int count, bool playing)
+{
+    QVariantMap changes;
+    changes.insert(QStringLiteral("PlaybackStatus"), playing ? QStringLiteral("Playing") : QStringLiteral("Paused"));
+    changes.insert(QStringLiteral("CanPlay"), !playing);
+    changes.insert(QStringLiteral("CanPause"), playing);
+    changes.insert(QStringLiteral("Position"), playing ? Q_INT64_C(1000000) : Q_INT64_C(2000000));
+    changes.insert(QStringLiteral("Rate"), playing ? 1.0 : 1.5);
+    changes.insert(QStringLiteral("Volume"), playing ? 0.5 : 0.8);
+    changes.insert(QStringLiteral("SupportedMimeTypes"), playing
+                   ? QStringList() << QStringLiteral("audio/mpeg")
+                   : QStringList() << QStringLiteral("audio/ogg") << QStringLiteral("audio/mpeg"));
+
+    while (changes.count() > count) {
+        changes.erase(--changes.end());
+    }
+
+    return changes;
+}
+
+void tst_PropertiesChanged::dispatch_data()
+{
+    QTest::addColumn<bool>("typed");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("typed, 1 property") << true << 1;
+    QTest::newRow("typed, 7 properties") << true << 7;
+    QTest::newRow("generic, 1 property") << false << 1;
+    QTest::newRow("generic, 7 properties") << false << 7;
+}
+
+// Cost of one PropertiesChanged signal through the descriptor table, from
+// the slot the signal is delivered to down to the change notifications
+void tst_PropertiesChanged::dispatch()
+{
+    QFETCH(bool, typed);
+    QFETCH(int, count);
+
+    BenchmarkInterface iface(m_connection, typed);
+
+    const QMetaObject *metaObject = iface.metaObject();
+    const QMetaMethod onPropertiesChanged = metaObject->method(
+                metaObject->indexOfSlot("onPropertiesChanged(QString,QVariantMap,QStringList)"));
+    QVERIFY(onPropertiesChanged.isValid());
+
+    const QString interfaceName = QLatin1String(benchmarkInterfaceName);
+    const QVariantMap playing = changes(count, true);
+    const QVariantMap paused = changes(count, false);
+    const QStringList invalidated;
+    QCOMPARE(playing.count(), count);
+
+    // Alternating values so the typed path emits its notify signals
+    bool flip = false;
+    QBENCHMARK {
+        onPropertiesChanged.invoke(&iface, Qt::DirectConnection,
+                                   Q_ARG(QString, interfaceName),
+                                   Q_ARG(QVariantMap, flip ? playing : paused),
+                                   Q_ARG(QStringList, invalidated));
+        flip = !flip;
+    }
+
+    if (typed) {
+        QCOMPARE(iface.canPause(), !flip);
+    }
+}
+
+void tst_PropertiesChanged::lookup_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1 property") << 1;
+    QTest::newRow("7 properties") << 7;
+}
+
+// The per signal lookups done before the descriptor table, a Latin-1
+// conversion and a metaobject search for every changed property. Compare
+// against the dispatch rows for the share of the cost they took.
+void tst_PropertiesChanged::lookup()
+{
+    QFETCH(int, count);
+
+    BenchmarkInterface iface(m_connection, true);
+
+    const QMetaObject *metaObject = iface.metaObject();
+    const QVariantMap playing = changes(count, true);
+
+    int found = 0;
+    QBENCHMARK {
+        QVariantMap::const_iterator i = playing.constBegin();
+        while (i != playing.constEnd()) {
+            int propertyIndex = metaObject->indexOfProperty(i.key().toLatin1().constData());
+            if (propertyIndex >= 0 && metaObject->property(propertyIndex).isValid()) {
+                ++found;
+            }
+            ++i;
+        }
+    }
+
+    QVERIFY(found >= count);
+}
+
+QTEST_GUILESS_MAIN(tst_PropertiesChanged)
+
+#include "tst_propertieschanged.moc"